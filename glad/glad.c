@@ -68,6 +68,7 @@ PFNGLFRONTFACEPROC glFrontFace = NULL;
 PFNGLDEPTHFUNCPROC glDepthFunc = NULL;
 PFNGLGETSTRINGPROC glGetString = NULL;
 PFNGLGETERRORPROC glGetError = NULL;
+PFNGLGETINTEGERVPROC glGetIntegerv = NULL;
 
 PFNGLCREATESHADERPROC glCreateShader = NULL;
 PFNGLSHADERSOURCEPROC glShaderSource = NULL;
@@ -88,6 +89,10 @@ PFNGLUNIFORM1FPROC glUniform1f = NULL;
 PFNGLUNIFORM3FPROC glUniform3f = NULL;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = NULL;
 
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = NULL;
+
 PFNGLGENBUFFERSPROC glGenBuffers = NULL;
 PFNGLDELETEBUFFERSPROC glDeleteBuffers = NULL;
 PFNGLBINDBUFFERPROC glBindBuffer = NULL;
@@ -98,9 +103,11 @@ PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = NULL;
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray = NULL;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = NULL;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = NULL;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = NULL;
 
 PFNGLDRAWARRAYSPROC glDrawArrays = NULL;
 PFNGLDRAWELEMENTSPROC glDrawElements = NULL;
+PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced = NULL;
 
 PFNGLGENTEXTURESPROC glGenTextures = NULL;
 PFNGLDELETETEXTURESPROC glDeleteTextures = NULL;
@@ -110,6 +117,25 @@ PFNGLTEXPARAMETERIPROC glTexParameteri = NULL;
 PFNGLACTIVETEXTUREPROC glActiveTexture = NULL;
 PFNGLGENERATEMIPMAPPROC glGenerateMipmap = NULL;
 
+PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = NULL;
+PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers = NULL;
+PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = NULL;
+PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D = NULL;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus = NULL;
+PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers = NULL;
+PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers = NULL;
+PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer = NULL;
+PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage = NULL;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer = NULL;
+PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer = NULL;
+
+PFNGLGENQUERIESPROC glGenQueries = NULL;
+PFNGLDELETEQUERIESPROC glDeleteQueries = NULL;
+PFNGLBEGINQUERYPROC glBeginQuery = NULL;
+PFNGLENDQUERYPROC glEndQuery = NULL;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv = NULL;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = NULL;
+
 int gladLoadGL(void) {
     if (!open_gl()) return 0;
     
@@ -125,6 +151,7 @@ int gladLoadGL(void) {
     glDepthFunc = (PFNGLDEPTHFUNCPROC)get_proc("glDepthFunc");
     glGetString = (PFNGLGETSTRINGPROC)get_proc("glGetString");
     glGetError = (PFNGLGETERRORPROC)get_proc("glGetError");
+    glGetIntegerv = (PFNGLGETINTEGERVPROC)get_proc("glGetIntegerv");
     
     // Load shader functions
     glCreateShader = (PFNGLCREATESHADERPROC)get_proc("glCreateShader");
@@ -146,6 +173,11 @@ int gladLoadGL(void) {
     glUniform3f = (PFNGLUNIFORM3FPROC)get_proc("glUniform3f");
     glUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)get_proc("glUniformMatrix4fv");
     
+    // Load program binary functions (optional)
+    glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)get_proc("glGetProgramBinary");
+    glProgramBinary = (PFNGLPROGRAMBINARYPROC)get_proc("glProgramBinary");
+    glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)get_proc("glProgramParameteri");
+    
     // Load buffer functions
     glGenBuffers = (PFNGLGENBUFFERSPROC)get_proc("glGenBuffers");
     glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)get_proc("glDeleteBuffers");
@@ -158,10 +190,12 @@ int gladLoadGL(void) {
     glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)get_proc("glBindVertexArray");
     glEnableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)get_proc("glEnableVertexAttribArray");
     glVertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)get_proc("glVertexAttribPointer");
+    glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)get_proc("glVertexAttribDivisor");
     
     // Load draw functions
     glDrawArrays = (PFNGLDRAWARRAYSPROC)get_proc("glDrawArrays");
     glDrawElements = (PFNGLDRAWELEMENTSPROC)get_proc("glDrawElements");
+    glDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC)get_proc("glDrawArraysInstanced");
     
     // Load texture functions
     glGenTextures = (PFNGLGENTEXTURESPROC)get_proc("glGenTextures");
@@ -172,5 +206,26 @@ int gladLoadGL(void) {
     glActiveTexture = (PFNGLACTIVETEXTUREPROC)get_proc("glActiveTexture");
     glGenerateMipmap = (PFNGLGENERATEMIPMAPPROC)get_proc("glGenerateMipmap");
     
+    // Load framebuffer functions
+    glGenFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)get_proc("glGenFramebuffers");
+    glDeleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC)get_proc("glDeleteFramebuffers");
+    glBindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)get_proc("glBindFramebuffer");
+    glFramebufferTexture2D = (PFNGLFRAMEBUFFERTEXTURE2DPROC)get_proc("glFramebufferTexture2D");
+    glCheckFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)get_proc("glCheckFramebufferStatus");
+    glGenRenderbuffers = (PFNGLGENRENDERBUFFERSPROC)get_proc("glGenRenderbuffers");
+    glDeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)get_proc("glDeleteRenderbuffers");
+    glBindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC)get_proc("glBindRenderbuffer");
+    glRenderbufferStorage = (PFNGLRENDERBUFFERSTORAGEPROC)get_proc("glRenderbufferStorage");
+    glFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)get_proc("glFramebufferRenderbuffer");
+    glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)get_proc("glBlitFramebuffer");
+    
+    // Load query functions
+    glGenQueries = (PFNGLGENQUERIESPROC)get_proc("glGenQueries");
+    glDeleteQueries = (PFNGLDELETEQUERIESPROC)get_proc("glDeleteQueries");
+    glBeginQuery = (PFNGLBEGINQUERYPROC)get_proc("glBeginQuery");
+    glEndQuery = (PFNGLENDQUERYPROC)get_proc("glEndQuery");
+    glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)get_proc("glGetQueryObjectiv");
+    glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)get_proc("glGetQueryObjectui64v");
+    
     return 1;
 }
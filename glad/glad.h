@@ -32,6 +32,8 @@ typedef khronos_uint16_t GLushort;
 typedef khronos_intptr_t GLintptr;
 typedef khronos_ssize_t GLsizeiptr;
 typedef char GLchar;
+typedef khronos_int64_t GLint64;
+typedef khronos_uint64_t GLuint64;
 
 // Boolean values
 #define GL_FALSE 0
@@ -83,6 +85,9 @@ typedef char GLchar;
 #define GL_COMPILE_STATUS 0x8B81
 #define GL_LINK_STATUS 0x8B82
 #define GL_INFO_LOG_LENGTH 0x8B84
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
 
 // Buffers
 #define GL_ARRAY_BUFFER 0x8892
@@ -115,6 +120,22 @@ typedef char GLchar;
 // Viewport
 #define GL_VIEWPORT 0x0BA2
 
+// Framebuffers
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_DEPTH_COMPONENT24 0x81A6
+#define GL_RGBA8 0x8058
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+
+// Queries
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+
 // Function pointer typedefs
 typedef void (*PFNGLCLEARPROC)(GLbitfield);
 typedef void (*PFNGLCLEARCOLORPROC)(GLfloat, GLfloat, GLfloat, GLfloat);
@@ -127,6 +148,7 @@ typedef void (*PFNGLFRONTFACEPROC)(GLenum);
 typedef void (*PFNGLDEPTHFUNCPROC)(GLenum);
 typedef const GLubyte* (*PFNGLGETSTRINGPROC)(GLenum);
 typedef GLenum (*PFNGLGETERRORPROC)(void);
+typedef void (*PFNGLGETINTEGERVPROC)(GLenum, GLint*);
 
 // Shader functions
 typedef GLuint (*PFNGLCREATESHADERPROC)(GLenum);
@@ -148,6 +170,11 @@ typedef void (*PFNGLUNIFORM1FPROC)(GLint, GLfloat);
 typedef void (*PFNGLUNIFORM3FPROC)(GLint, GLfloat, GLfloat, GLfloat);
 typedef void (*PFNGLUNIFORMMATRIX4FVPROC)(GLint, GLsizei, GLboolean, const GLfloat*);
 
+// Program binary functions (GL 4.1 / ARB_get_program_binary, may be NULL)
+typedef void (*PFNGLGETPROGRAMBINARYPROC)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+typedef void (*PFNGLPROGRAMBINARYPROC)(GLuint, GLenum, const void*, GLsizei);
+typedef void (*PFNGLPROGRAMPARAMETERIPROC)(GLuint, GLenum, GLint);
+
 // Buffer functions
 typedef void (*PFNGLGENBUFFERSPROC)(GLsizei, GLuint*);
 typedef void (*PFNGLDELETEBUFFERSPROC)(GLsizei, const GLuint*);
@@ -160,10 +187,12 @@ typedef void (*PFNGLDELETEVERTEXARRAYSPROC)(GLsizei, const GLuint*);
 typedef void (*PFNGLBINDVERTEXARRAYPROC)(GLuint);
 typedef void (*PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint);
 typedef void (*PFNGLVERTEXATTRIBPOINTERPROC)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+typedef void (*PFNGLVERTEXATTRIBDIVISORPROC)(GLuint, GLuint);
 
 // Draw functions
 typedef void (*PFNGLDRAWARRAYSPROC)(GLenum, GLint, GLsizei);
 typedef void (*PFNGLDRAWELEMENTSPROC)(GLenum, GLsizei, GLenum, const void*);
+typedef void (*PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum, GLint, GLsizei, GLsizei);
 
 // Texture functions
 typedef void (*PFNGLGENTEXTURESPROC)(GLsizei, GLuint*);
@@ -174,6 +203,27 @@ typedef void (*PFNGLTEXPARAMETERIPROC)(GLenum, GLenum, GLint);
 typedef void (*PFNGLACTIVETEXTUREPROC)(GLenum);
 typedef void (*PFNGLGENERATEMIPMAPPROC)(GLenum);
 
+// Framebuffer functions
+typedef void (*PFNGLGENFRAMEBUFFERSPROC)(GLsizei, GLuint*);
+typedef void (*PFNGLDELETEFRAMEBUFFERSPROC)(GLsizei, const GLuint*);
+typedef void (*PFNGLBINDFRAMEBUFFERPROC)(GLenum, GLuint);
+typedef void (*PFNGLFRAMEBUFFERTEXTURE2DPROC)(GLenum, GLenum, GLenum, GLuint, GLint);
+typedef GLenum (*PFNGLCHECKFRAMEBUFFERSTATUSPROC)(GLenum);
+typedef void (*PFNGLGENRENDERBUFFERSPROC)(GLsizei, GLuint*);
+typedef void (*PFNGLDELETERENDERBUFFERSPROC)(GLsizei, const GLuint*);
+typedef void (*PFNGLBINDRENDERBUFFERPROC)(GLenum, GLuint);
+typedef void (*PFNGLRENDERBUFFERSTORAGEPROC)(GLenum, GLenum, GLsizei, GLsizei);
+typedef void (*PFNGLFRAMEBUFFERRENDERBUFFERPROC)(GLenum, GLenum, GLenum, GLuint);
+typedef void (*PFNGLBLITFRAMEBUFFERPROC)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+
+// Query functions
+typedef void (*PFNGLGENQUERIESPROC)(GLsizei, GLuint*);
+typedef void (*PFNGLDELETEQUERIESPROC)(GLsizei, const GLuint*);
+typedef void (*PFNGLBEGINQUERYPROC)(GLenum, GLuint);
+typedef void (*PFNGLENDQUERYPROC)(GLenum);
+typedef void (*PFNGLGETQUERYOBJECTIVPROC)(GLuint, GLenum, GLint*);
+typedef void (*PFNGLGETQUERYOBJECTUI64VPROC)(GLuint, GLenum, GLuint64*);
+
 // Function declarations
 extern PFNGLCLEARPROC glClear;
 extern PFNGLCLEARCOLORPROC glClearColor;
@@ -186,6 +236,7 @@ extern PFNGLFRONTFACEPROC glFrontFace;
 extern PFNGLDEPTHFUNCPROC glDepthFunc;
 extern PFNGLGETSTRINGPROC glGetString;
 extern PFNGLGETERRORPROC glGetError;
+extern PFNGLGETINTEGERVPROC glGetIntegerv;
 
 extern PFNGLCREATESHADERPROC glCreateShader;
 extern PFNGLSHADERSOURCEPROC glShaderSource;
@@ -206,6 +257,10 @@ extern PFNGLUNIFORM1FPROC glUniform1f;
 extern PFNGLUNIFORM3FPROC glUniform3f;
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
 
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
 extern PFNGLGENBUFFERSPROC glGenBuffers;
 extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
 extern PFNGLBINDBUFFERPROC glBindBuffer;
@@ -216,9 +271,11 @@ extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
 
 extern PFNGLDRAWARRAYSPROC glDrawArrays;
 extern PFNGLDRAWELEMENTSPROC glDrawElements;
+extern PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced;
 
 extern PFNGLGENTEXTURESPROC glGenTextures;
 extern PFNGLDELETETEXTURESPROC glDeleteTextures;
@@ -228,6 +285,25 @@ extern PFNGLTEXPARAMETERIPROC glTexParameteri;
 extern PFNGLACTIVETEXTUREPROC glActiveTexture;
 extern PFNGLGENERATEMIPMAPPROC glGenerateMipmap;
 
+extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
+extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
+extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
+extern PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
+extern PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
+extern PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers;
+extern PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers;
+extern PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer;
+extern PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
+extern PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer;
+extern PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
+
+extern PFNGLGENQUERIESPROC glGenQueries;
+extern PFNGLDELETEQUERIESPROC glDeleteQueries;
+extern PFNGLBEGINQUERYPROC glBeginQuery;
+extern PFNGLENDQUERYPROC glEndQuery;
+extern PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+
 // Initialization function
 int gladLoadGL(void);
 
@@ -1,27 +1,40 @@
 #version 330 core
 
 in vec3 fragNormal;
-in vec3 fragColor;
 in vec3 fragPos;
+#ifdef VERTEX_COLOR
+in vec3 fragColor;
+#endif
+#ifdef TEXTURED
 in vec2 fragTexCoord;
+#endif
+#ifdef FOG
+in float fragViewDepth;
+#endif
 
 out vec4 FragColor;
 
 uniform vec3 lightDir = normalize(vec3(1.0, 1.0, 0.5));
 uniform float ambientStrength = 0.6;
 uniform vec3 colorTint = vec3(1.0, 1.0, 1.0);
+#ifdef TEXTURED
 uniform sampler2D textureSampler;
-uniform bool useTexture = false;
+#endif
+#ifdef FOG
+uniform vec3 fogColor = vec3(0.5, 0.7, 0.9);
+uniform float fogStart = 30.0;
+uniform float fogEnd = 80.0;
+#endif
 
 void main() {
-    vec3 baseColor;
-    
-    if (useTexture) {
-        vec4 texColor = texture(textureSampler, fragTexCoord);
-        baseColor = texColor.rgb * colorTint;
-    } else {
-        baseColor = fragColor * colorTint;
-    }
+#if defined(TEXTURED)
+    vec4 texColor = texture(textureSampler, fragTexCoord);
+    vec3 baseColor = texColor.rgb * colorTint;
+#elif defined(VERTEX_COLOR)
+    vec3 baseColor = fragColor * colorTint;
+#else
+    vec3 baseColor = colorTint;
+#endif
     
     vec3 ambient = ambientStrength * baseColor;
     
@@ -31,5 +44,10 @@ void main() {
     
     vec3 result = ambient + diffuse;
     
+#ifdef FOG
+    float fogAmount = clamp((fragViewDepth - fogStart) / (fogEnd - fogStart), 0.0, 1.0);
+    result = mix(result, fogColor, fogAmount);
+#endif
+    
     FragColor = vec4(result, 1.0);
 }
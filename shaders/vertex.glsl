@@ -4,20 +4,44 @@ layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec3 aColor;
 layout(location = 3) in vec2 aTexCoord;
-
+#ifdef INSTANCED
+layout(location = 4) in mat4 aInstanceModel;
+#else
 uniform mat4 model;
+#endif
+
 uniform mat4 view;
 uniform mat4 projection;
 
 out vec3 fragNormal;
-out vec3 fragColor;
 out vec3 fragPos;
+#ifdef VERTEX_COLOR
+out vec3 fragColor;
+#endif
+#ifdef TEXTURED
 out vec2 fragTexCoord;
+#endif
+#ifdef FOG
+out float fragViewDepth;
+#endif
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPosition, 1.0);
-    fragPos = vec3(model * vec4(aPosition, 1.0));
-    fragNormal = mat3(transpose(inverse(model))) * aNormal;
+#ifdef INSTANCED
+    mat4 modelMat = aInstanceModel;
+#else
+    mat4 modelMat = model;
+#endif
+    vec4 viewPos = view * modelMat * vec4(aPosition, 1.0);
+    gl_Position = projection * viewPos;
+    fragPos = vec3(modelMat * vec4(aPosition, 1.0));
+    fragNormal = mat3(transpose(inverse(modelMat))) * aNormal;
+#ifdef VERTEX_COLOR
     fragColor = aColor;
+#endif
+#ifdef TEXTURED
     fragTexCoord = aTexCoord;
+#endif
+#ifdef FOG
+    fragViewDepth = -viewPos.z;
+#endif
 }
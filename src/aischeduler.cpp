@@ -0,0 +1,64 @@
+#include "aischeduler.h"
+#include "entitystore.h"
+#include "maze.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Off-screen ghosts sort after every on-screen one
+    const uint32_t OFF_SCREEN = 1u << 30;
+}
+
+void AiScheduler::setView(glm::ivec2 min_tile, glm::ivec2 max_tile) {
+    hasView = true;
+    viewMin = min_tile;
+    viewMax = max_tile;
+}
+
+void AiScheduler::think(EntityStore& store, const Maze& maze, glm::ivec2 pacman_pos, SimRandom& rng) {
+    auto start = Clock::now();
+    const size_t count = store.size();
+    const JunctionGraph& graph = maze.getJunctionGraph();
+
+    randoms.resize(count);
+    queue.clear();
+    for (size_t i = 0; i < count; i++) {
+        randoms[i] = rng.next();
+        if (!store.isIdle(i)) continue;
+
+        glm::ivec2 tile(store.gridX[i], store.gridY[i]);
+        uint32_t priority = static_cast<uint32_t>(Ghost::manhattanDistance(tile, pacman_pos));
+        if (hasView && (tile.x < viewMin.x || tile.y < viewMin.y || tile.x > viewMax.x || tile.y > viewMax.y)) {
+            priority |= OFF_SCREEN;
+        }
+        queue.push_back(static_cast<uint64_t>(priority) << 32 | i);
+    }
+    std::sort(queue.begin(), queue.end());
+
+    // Full AI in priority order until the budget is gone
+    const bool limited = budgetMicros > 0.0;
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::micro>(budgetMicros));
+    size_t next = 0;
+    for (; next < queue.size(); next++) {
+        if (limited && (next % CLOCK_INTERVAL) == 0 && next > 0 && Clock::now() >= deadline) break;
+        size_t i = static_cast<uint32_t>(queue[next]);
+        store.thinkOne(i, maze, graph, pacman_pos, randoms[i]);
+    }
+    stats.decisions += next;
+
+    for (size_t rest = next; rest < queue.size(); rest++) {
+        size_t i = static_cast<uint32_t>(queue[rest]);
+        store.thinkFallback(i, maze, graph, randoms[i]);
+        if (hasView && !((queue[rest] >> 32) & OFF_SCREEN)) stats.visibleFallbacks++;
+    }
+    stats.fallbacks += queue.size() - next;
+
+    double micros = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    if (limited && micros > budgetMicros) stats.overruns++;
+    stats.worstMicros = std::max(stats.worstMicros, micros);
+    stats.seconds += micros / 1e6;
+    stats.ticks++;
+}
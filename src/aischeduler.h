@@ -0,0 +1,62 @@
+#ifndef AISCHEDULER_H
+#define AISCHEDULER_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "simrandom.h"
+
+class EntityStore;
+class Maze;
+
+/**
+ * Time-sliced replacement for EntityStore::think. Each tick the ghosts
+ * that need a decision are ordered by priority (on screen first, then
+ * nearest to Pac-Man) and get the full Ghost rules until the per-tick
+ * budget is spent; the rest take the cheap corridor rule
+ * (EntityStore::thinkFallback) and catch up on a later tile.
+ *
+ * Random numbers are still drawn one per entity in entity order, so the
+ * game's RNG stream does not depend on how much work fit in the budget.
+ */
+class AiScheduler {
+public:
+    // Totals since construction (or resetStats)
+    struct Stats {
+        uint64_t ticks = 0;
+        uint64_t decisions = 0;   // full AI
+        uint64_t fallbacks = 0;   // cheap rule after the budget ran out
+        uint64_t visibleFallbacks = 0;  // of those, ghosts on screen
+        uint64_t overruns = 0;    // ticks whose AI took longer than the budget
+        double seconds = 0.0;
+        double worstMicros = 0.0; // slowest tick
+    };
+
+    // Microseconds of full AI per tick (0 = unlimited)
+    void setBudget(double micros) { budgetMicros = micros; }
+    double getBudget() const { return budgetMicros; }
+
+    // Tiles currently on screen, inclusive (default: the whole maze)
+    void setView(glm::ivec2 min_tile, glm::ivec2 max_tile);
+    void clearView() { hasView = false; }
+
+    void think(EntityStore& store, const Maze& maze, glm::ivec2 pacman_pos, SimRandom& rng);
+
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats(); }
+
+    // Full decisions between clock reads
+    static constexpr uint32_t CLOCK_INTERVAL = 16;
+
+private:
+    double budgetMicros = 0.0;
+    bool hasView = false;
+    glm::ivec2 viewMin{0, 0};
+    glm::ivec2 viewMax{0, 0};
+    Stats stats;
+
+    std::vector<uint32_t> randoms;
+    std::vector<uint64_t> queue;   // priority << 32 | entity
+};
+
+#endif // AISCHEDULER_H
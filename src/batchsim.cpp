@@ -0,0 +1,394 @@
+#include "batchsim.h"
+#include "ghost.h"
+#include "pacman.h"
+#include "pathtable.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Games per thread pool chunk: enough to amortise the hand-off while
+    // keeping each chunk's arrays in L1/L2
+    const size_t GAMES_PER_CHUNK = 64;
+
+    const float PACMAN_MOVE_DURATION = 0.18f;
+    const int8_t NO_DIRECTION = static_cast<int8_t>(Direction::NONE);
+}
+
+BatchSim::BatchSim()
+    : count(0)
+    , width(0)
+    , height(0)
+    , pelletTotal(0)
+{}
+
+BatchSim::~BatchSim() = default;
+
+bool BatchSim::init(const std::string& level_path, int game_count, unsigned int threads) {
+    if (!maze.load(level_path)) return false;
+    if (!maze.getBits().isValid()) {
+        std::cerr << "ERROR::BATCHSIM: " << level_path << " is wider than "
+                  << MazeBits::MAX_WIDTH << " tiles" << std::endl;
+        return false;
+    }
+
+    // Games on different threads share the maze, so ghosts must steer by
+    // the read-only path tables rather than the maze's distance field
+    std::shared_ptr<const PathTable> table = PathTable::loadOrBuild(maze, level_path + ".paths");
+    if (!table) {
+        std::cerr << "ERROR::BATCHSIM: No path table for " << level_path << std::endl;
+        return false;
+    }
+    maze.setPathTable(table);
+    return allocate(game_count, threads);
+}
+
+bool BatchSim::init(const Maze& layout, int game_count, unsigned int threads) {
+    maze = layout;
+    if (!maze.getBits().isValid()) {
+        std::cerr << "ERROR::BATCHSIM: Layout is wider than " << MazeBits::MAX_WIDTH << " tiles" << std::endl;
+        return false;
+    }
+    if (!maze.getPathTable()) {
+        auto table = std::make_shared<PathTable>();
+        if (!table->build(maze)) {
+            std::cerr << "ERROR::BATCHSIM: No path table for layout" << std::endl;
+            return false;
+        }
+        maze.setPathTable(table);
+    }
+    return allocate(game_count, threads);
+}
+
+bool BatchSim::allocate(int game_count, unsigned int threads) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    pelletTemplate = maze.getBits().getPelletRows();
+    powerTemplate = maze.getBits().getPowerRows();
+    pelletTotal = maze.getRemainingPellets();
+
+    count = std::max(game_count, 0);
+    size_t n = static_cast<size_t>(count);
+    size_t g = n * GHOST_COUNT;
+
+    pacX.assign(n, 0); pacY.assign(n, 0);
+    pacDir.assign(n, NO_DIRECTION); pacBuffered.assign(n, NO_DIRECTION);
+    pacMoving.assign(n, 0); pacElapsed.assign(n, 0.0f);
+    powerTime.assign(n, 0.0f); powered.assign(n, 0);
+    score.assign(n, 0); lives.assign(n, 0); pelletsLeft.assign(n, 0); ghostEatBonus.assign(n, 0);
+    dead.assign(n, 0); gameOver.assign(n, 0); cleared.assign(n, 0); active.assign(n, 0);
+    deathTimer.assign(n, 0.0f);
+    rng.assign(n, SimRandom());
+    ticks.assign(n, 0);
+    pellets.assign(n * height, 0);
+    powers.assign(n * height, 0);
+
+    ghostX.assign(g, 0); ghostY.assign(g, 0);
+    targetX.assign(g, 0); targetY.assign(g, 0);
+    ghostDir.assign(g, NO_DIRECTION);
+    ghostMoving.assign(g, 0); ghostMode.assign(g, 0); ghostEaten.assign(g, 0);
+    ghostElapsed.assign(g, 0.0f); ghostDuration.assign(g, 0.0f); frightTime.assign(g, 0.0f);
+
+    pool = std::make_unique<ThreadPool>(threads);
+
+    // One influence map per worker; each is refreshed for whichever game
+    // it is deciding frightened moves for
+    influence.assign(pool->getThreadCount(), InfluenceMap());
+    for (InfluenceMap& map : influence) map.build(maze, maze.getInfo().ghostSpawns, GHOST_COUNT);
+    reset(nullptr);
+
+    std::cout << "Batch: " << count << " games on " << pool->getThreadCount() << " threads" << std::endl;
+    return true;
+}
+
+void BatchSim::reset(const uint64_t* seeds) {
+    for (int i = 0; i < count; i++) {
+        resetGame(i, seeds ? seeds[i] : static_cast<uint64_t>(i));
+    }
+}
+
+void BatchSim::resetGame(int game, uint64_t seed) {
+    size_t i = static_cast<size_t>(game);
+    score[i] = 0;
+    lives[i] = 3;
+    gameOver[i] = 0;
+    cleared[i] = 0;
+    deathTimer[i] = 0.0f;
+    ghostEatBonus[i] = Simulation::FIRST_GHOST_BONUS;
+    pelletsLeft[i] = pelletTotal;
+    rng[i].seed(seed);
+    ticks[i] = 0;
+    std::copy(pelletTemplate.begin(), pelletTemplate.end(), pellets.begin() + i * height);
+    std::copy(powerTemplate.begin(), powerTemplate.end(), powers.begin() + i * height);
+
+    for (int k = 0; k < GHOST_COUNT; k++) {
+        targetX[i * GHOST_COUNT + k] = 0;
+        targetY[i * GHOST_COUNT + k] = 0;
+    }
+    respawnEntities(game);
+}
+
+void BatchSim::respawnEntities(int game) {
+    size_t i = static_cast<size_t>(game);
+    const LevelInfo& info = maze.getInfo();
+    pacX[i] = info.pacmanSpawn.x;
+    pacY[i] = info.pacmanSpawn.y;
+    pacDir[i] = NO_DIRECTION;
+    pacBuffered[i] = NO_DIRECTION;
+    pacMoving[i] = 0;
+    pacElapsed[i] = 0.0f;
+    powered[i] = 0;
+    powerTime[i] = 0.0f;
+    dead[i] = 0;
+
+    for (int k = 0; k < GHOST_COUNT; k++) {
+        size_t g = i * GHOST_COUNT + k;
+        ghostX[g] = info.ghostSpawns[k].x;
+        ghostY[g] = info.ghostSpawns[k].y;
+        ghostDir[g] = NO_DIRECTION;
+        ghostMoving[g] = 0;
+        ghostElapsed[g] = 0.0f;
+        ghostDuration[g] = Ghost::getMoveDuration(static_cast<GhostType>(k));
+        ghostMode[g] = static_cast<uint8_t>(GhostMode::CHASE);
+        ghostEaten[g] = 0;
+        frightTime[g] = 0.0f;
+    }
+}
+
+void BatchSim::step(const int8_t* actions, float* rewards, uint8_t* dones) {
+    if (count == 0) return;
+    pool->parallelFor(static_cast<size_t>(count), GAMES_PER_CHUNK, [&](size_t begin, size_t end, unsigned int worker) {
+        stepRange(begin, end, actions, rewards, dones, influence[worker]);
+    });
+}
+
+void BatchSim::stepRange(size_t begin, size_t end, const int8_t* actions, float* rewards, uint8_t* dones,
+                         InfluenceMap& map) {
+    const float dt = TICK_DT;
+
+    // Rewards start as minus the old score; the new score is added at the end
+    for (size_t i = begin; i < end; i++) {
+        if (rewards) rewards[i] = -static_cast<float>(score[i]);
+        ticks[i]++;
+        active[i] = !gameOver[i] && !dead[i];
+    }
+
+    // Dying: count down, then respawn or end the game (as Simulation::step)
+    for (size_t i = begin; i < end; i++) {
+        if (!dead[i] || gameOver[i]) continue;
+        deathTimer[i] -= dt;
+        if (deathTimer[i] <= 0.0f) {
+            if (lives[i] <= 0) gameOver[i] = 1;
+            else respawnEntities(static_cast<int>(i));
+        }
+    }
+
+    // Pac-Man input and movement
+    for (size_t i = begin; i < end; i++) {
+        if (!active[i]) continue;
+        Direction input = actions ? static_cast<Direction>(actions[i]) : Direction::NONE;
+        stepPacman(static_cast<int>(i), input);
+    }
+
+    // Pac-Man move and power timers, branch-free so the loop vectorises
+    for (size_t i = begin; i < end; i++) {
+        bool moving = active[i] && pacMoving[i];
+        float elapsed = pacElapsed[i] + (moving ? dt : 0.0f);
+        bool arrived = moving && elapsed >= PACMAN_MOVE_DURATION;
+        pacElapsed[i] = arrived ? 0.0f : elapsed;
+        pacMoving[i] = static_cast<uint8_t>(moving ? !arrived : pacMoving[i]);
+
+        bool power = active[i] && powered[i];
+        float left = powerTime[i] - (power ? dt : 0.0f);
+        powerTime[i] = left;
+        powered[i] = static_cast<uint8_t>(power ? left > 0.0f : powered[i]);
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        if (active[i]) collectPellet(static_cast<int>(i));
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        if (active[i]) thinkGhosts(static_cast<int>(i), map);
+    }
+
+    // Ghost move and frightened timers (eaten ghosts are frozen)
+    for (size_t g = begin * GHOST_COUNT; g < end * GHOST_COUNT; g++) {
+        bool live = active[g / GHOST_COUNT] && !ghostEaten[g];
+        bool moving = live && ghostMoving[g];
+        float elapsed = ghostElapsed[g] + (moving ? dt : 0.0f);
+        bool arrived = moving && elapsed >= ghostDuration[g];
+        ghostElapsed[g] = arrived ? 0.0f : elapsed;
+        ghostMoving[g] = static_cast<uint8_t>(moving ? !arrived : ghostMoving[g]);
+
+        bool frightened = live && ghostMode[g] == static_cast<uint8_t>(GhostMode::FRIGHTENED);
+        float left = frightTime[g] - (frightened ? dt : 0.0f);
+        frightTime[g] = left;
+        ghostMode[g] = (frightened && left <= 0.0f) ? static_cast<uint8_t>(GhostMode::CHASE) : ghostMode[g];
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        if (active[i]) resolveCollisions(static_cast<int>(i));
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        if (rewards) rewards[i] += static_cast<float>(score[i]);
+        if (dones) dones[i] = gameOver[i];
+    }
+}
+
+void BatchSim::stepPacman(int game, Direction input) {
+    size_t i = static_cast<size_t>(game);
+
+    // Entity::tryMove on the SoA fields
+    auto tryMove = [&](Direction dir) {
+        if (pacMoving[i]) return false;
+        uint32_t next = maze.getNeighbour(pacX[i], pacY[i], dir);
+        if (next == Maze::NO_NEIGHBOUR) return false;
+        pacX[i] = static_cast<int32_t>(next % width);
+        pacY[i] = static_cast<int32_t>(next / width);
+        pacDir[i] = static_cast<int8_t>(dir);
+        pacMoving[i] = 1;
+        pacElapsed[i] = 0.0f;
+        return true;
+    };
+
+    // PacMan::handleInput, then PacMan::continueMovement
+    Direction current = static_cast<Direction>(pacDir[i]);
+    if (input != Direction::NONE) {
+        pacBuffered[i] = static_cast<int8_t>(input);
+        if (!pacMoving[i] && !tryMove(input) && current != Direction::NONE) {
+            tryMove(current);
+        }
+    }
+
+    if (pacMoving[i]) return;
+    Direction buffered = static_cast<Direction>(pacBuffered[i]);
+    if (buffered != Direction::NONE && tryMove(buffered)) return;
+    current = static_cast<Direction>(pacDir[i]);
+    if (current != Direction::NONE) tryMove(current);
+}
+
+void BatchSim::collectPellet(int game) {
+    size_t i = static_cast<size_t>(game);
+    size_t row = i * height + pacY[i];
+    uint64_t bit = 1ull << pacX[i];
+
+    if (pellets[row] & bit) {
+        pellets[row] &= ~bit;
+        score[i] += PacMan::PELLET_POINTS;
+    } else if (powers[row] & bit) {
+        powers[row] &= ~bit;
+        score[i] += PacMan::POWER_POINTS;
+        powered[i] = 1;
+        powerTime[i] = PacMan::POWER_DURATION;
+
+        // Ghost::setFrightened
+        ghostEatBonus[i] = Simulation::FIRST_GHOST_BONUS;
+        for (int k = 0; k < GHOST_COUNT; k++) {
+            size_t g = i * GHOST_COUNT + k;
+            if (ghostEaten[g]) continue;
+            ghostMode[g] = static_cast<uint8_t>(GhostMode::FRIGHTENED);
+            frightTime[g] = PacMan::POWER_DURATION;
+            ghostDuration[g] *= 1.5f;
+        }
+    } else {
+        return;
+    }
+
+    if (--pelletsLeft[i] == 0) {
+        gameOver[i] = 1;
+        cleared[i] = 1;
+    }
+}
+
+void BatchSim::thinkGhosts(int game, InfluenceMap& map) {
+    size_t i = static_cast<size_t>(game);
+    glm::ivec2 pacmanPos(pacX[i], pacY[i]);
+
+    for (int k = 0; k < GHOST_COUNT; k++) {
+        size_t g = i * GHOST_COUNT + k;
+
+        // Drawn for every ghost, as Simulation passes rng.next() to each updateAI
+        uint32_t random = rng[i].next();
+        if (ghostEaten[g] || ghostMoving[g]) continue;
+
+        Direction current = static_cast<Direction>(ghostDir[g]);
+        Direction dir = Direction::NONE;
+
+        // Entity::followCorridor
+        if (current != Direction::NONE) {
+            dir = maze.getJunctionGraph().continueCorridor(ghostX[g], ghostY[g], current);
+        }
+        if (dir == Direction::NONE || maze.getNeighbour(ghostX[g], ghostY[g], dir) == Maze::NO_NEIGHBOUR) {
+            GhostMode mode = static_cast<GhostMode>(ghostMode[g]);
+            glm::ivec2 grid(ghostX[g], ghostY[g]);
+            glm::ivec2 target = Ghost::chooseTarget(maze, static_cast<GhostType>(k), mode, grid, pacmanPos,
+                                                    glm::ivec2(targetX[g], targetY[g]));
+            targetX[g] = target.x;
+            targetY[g] = target.y;
+            if (mode == GhostMode::FRIGHTENED) {
+                map.update(maze, pacmanPos, static_cast<Direction>(pacDir[i]));
+                dir = Ghost::chooseFleeDirection(maze, grid, current, map, random);
+            } else {
+                dir = Ghost::chooseDirection(maze, grid, current, mode, target, random);
+            }
+        }
+
+        uint32_t next = maze.getNeighbour(ghostX[g], ghostY[g], dir);
+        if (next == Maze::NO_NEIGHBOUR) continue;
+        ghostX[g] = static_cast<int32_t>(next % width);
+        ghostY[g] = static_cast<int32_t>(next / width);
+        ghostDir[g] = static_cast<int8_t>(dir);
+        ghostMoving[g] = 1;
+        ghostElapsed[g] = 0.0f;
+    }
+}
+
+void BatchSim::resolveCollisions(int game) {
+    size_t i = static_cast<size_t>(game);
+    for (int k = 0; k < GHOST_COUNT; k++) {
+        size_t g = i * GHOST_COUNT + k;
+        if (ghostEaten[g] || dead[i] || cleared[i]) continue;
+
+        // Same tile, or swapping tiles along one edge (as Simulation)
+        bool hit = ghostX[g] == pacX[i] && ghostY[g] == pacY[i];
+        if (!hit && pacMoving[i] && ghostMoving[g]) {
+            uint32_t pacTile = static_cast<uint32_t>(pacY[i] * width + pacX[i]);
+            uint32_t ghostTile = static_cast<uint32_t>(ghostY[g] * width + ghostX[g]);
+            hit = maze.getNeighbour(pacTile, Entity::getOppositeDirection(static_cast<Direction>(pacDir[i]))) == ghostTile &&
+                  maze.getNeighbour(ghostTile, Entity::getOppositeDirection(static_cast<Direction>(ghostDir[g]))) == pacTile;
+        }
+        if (!hit) continue;
+
+        if (ghostMode[g] == static_cast<uint8_t>(GhostMode::FRIGHTENED)) {
+            ghostEaten[g] = 1;
+            score[i] += ghostEatBonus[i];
+            ghostEatBonus[i] *= 2;
+        } else {
+            lives[i]--;
+            dead[i] = 1;
+            deathTimer[i] = Simulation::DEATH_DELAY;
+        }
+    }
+}
+
+void BatchSim::observe(int32_t* out) const {
+    for (int i = 0; i < count; i++) {
+        int32_t* obs = out + static_cast<size_t>(i) * OBS_SIZE;
+        obs[0] = pacX[i];
+        obs[1] = pacY[i];
+        obs[2] = score[i];
+        obs[3] = lives[i];
+        obs[4] = (gameOver[i] ? FLAG_GAME_OVER : 0) | (cleared[i] ? FLAG_CLEARED : 0) |
+                 (dead[i] ? FLAG_DEAD : 0) | (powered[i] ? FLAG_POWERED : 0);
+        obs[5] = pelletsLeft[i];
+        for (int k = 0; k < GHOST_COUNT; k++) {
+            size_t g = static_cast<size_t>(i) * GHOST_COUNT + k;
+            obs[6 + k * 3] = ghostX[g];
+            obs[7 + k * 3] = ghostY[g];
+            obs[8 + k * 3] = ghostEaten[g] ? GHOST_EATEN : ghostMode[g];
+        }
+    }
+}
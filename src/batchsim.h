@@ -0,0 +1,119 @@
+#ifndef BATCHSIM_H
+#define BATCHSIM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "influencemap.h"
+#include "maze.h"
+#include "simrandom.h"
+
+class ThreadPool;
+
+/**
+ * N independent games on one level, stored structure-of-arrays and
+ * stepped together. Each game follows the same rules as Simulation
+ * (Ghost::chooseTarget/chooseDirection/chooseFleeDirection, the maze neighbour links and
+ * PacMan's scoring), so with the same seed and inputs a batch game
+ * matches a Simulation tick for tick.
+ *
+ * The maze layout and path tables are shared; per game state is entity
+ * positions, directions, timers and a pellet bitboard.
+ */
+class BatchSim {
+public:
+    static constexpr int GHOST_COUNT = 4;
+
+    // observe(): pacX, pacY, score, lives, flags, pelletsLeft, then x, y, state per ghost
+    static constexpr int OBS_SIZE = 6 + GHOST_COUNT * 3;
+    static constexpr int FLAG_GAME_OVER = 1;
+    static constexpr int FLAG_CLEARED = 2;
+    static constexpr int FLAG_DEAD = 4;
+    static constexpr int FLAG_POWERED = 8;
+
+    // Ghost state in observations
+    static constexpr int GHOST_CHASE = 0;
+    static constexpr int GHOST_SCATTER = 1;
+    static constexpr int GHOST_FRIGHTENED = 2;
+    static constexpr int GHOST_EATEN = 3;
+
+    static constexpr float TICK_DT = 1.0f / 120.0f;
+
+    BatchSim();
+    ~BatchSim();
+
+    // Load the level and allocate count games (0 threads = all cores)
+    bool init(const std::string& level_path, int count, unsigned int threads = 0);
+
+    // Same with a layout built in memory, e.g. by MazeGenerator (its path
+    // table is built here if it has none)
+    bool init(const Maze& layout, int count, unsigned int threads = 0);
+
+    int size() const { return count; }
+    int getRowCount() const { return height; }
+    const Maze& getMaze() const { return maze; }
+
+    // Restart every game; seeds holds one per game (nullptr: seed = index)
+    void reset(const uint64_t* seeds);
+    void resetGame(int game, uint64_t seed);
+
+    // Advance every running game one tick. actions holds one Direction per
+    // game (-1 = no input). rewards/dones (either may be nullptr) receive
+    // score gained this tick and 1 for finished games.
+    void step(const int8_t* actions, float* rewards, uint8_t* dones);
+
+    // Write OBS_SIZE ints per game into out
+    void observe(int32_t* out) const;
+
+    // Pellet bitboards of one game (getRowCount() words, bit x = column x)
+    const uint64_t* getPelletRows(int game) const { return &pellets[static_cast<size_t>(game) * height]; }
+    const uint64_t* getPowerRows(int game) const { return &powers[static_cast<size_t>(game) * height]; }
+
+    int getScore(int game) const { return score[game]; }
+    int getLives(int game) const { return lives[game]; }
+    bool isGameOver(int game) const { return gameOver[game] != 0; }
+
+private:
+    Maze maze;
+    int count;
+    int width;
+    int height;
+    std::vector<uint64_t> pelletTemplate;
+    std::vector<uint64_t> powerTemplate;
+    int pelletTotal;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<InfluenceMap> influence;   // per worker
+
+    // Per game
+    std::vector<int32_t> pacX, pacY;
+    std::vector<int8_t> pacDir, pacBuffered;
+    std::vector<uint8_t> pacMoving;
+    std::vector<float> pacElapsed;
+    std::vector<float> powerTime;
+    std::vector<uint8_t> powered;
+    std::vector<int32_t> score, lives, pelletsLeft, ghostEatBonus;
+    std::vector<uint8_t> dead, gameOver, cleared, active;
+    std::vector<float> deathTimer;
+    std::vector<SimRandom> rng;
+    std::vector<uint64_t> ticks;
+    std::vector<uint64_t> pellets, powers;
+
+    // Per ghost, index game * GHOST_COUNT + ghost
+    std::vector<int32_t> ghostX, ghostY, targetX, targetY;
+    std::vector<int8_t> ghostDir;
+    std::vector<uint8_t> ghostMoving, ghostMode, ghostEaten;
+    std::vector<float> ghostElapsed, ghostDuration, frightTime;
+
+    // Size every array for the loaded maze and start the workers
+    bool allocate(int count, unsigned int threads);
+    void respawnEntities(int game);
+    void stepRange(size_t begin, size_t end, const int8_t* actions, float* rewards, uint8_t* dones,
+                   InfluenceMap& map);
+    void stepPacman(int game, Direction input);
+    void collectPellet(int game);
+    void thinkGhosts(int game, InfluenceMap& map);
+    void resolveCollisions(int game);
+};
+
+#endif // BATCHSIM_H
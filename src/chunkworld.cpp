@@ -0,0 +1,292 @@
+#include "chunkworld.h"
+#include "mazegen.h"
+#include "pacman.h"
+#include "simrandom.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+    static_assert(ChunkWorld::CHUNK_WIDTH % 4 == 0 && ChunkWorld::CHUNK_WIDTH <= 32,
+                  "chunk rows are one 32-bit pellet word, width a multiple of 4 for the generator");
+    static_assert(ChunkWorld::CHUNK_HEIGHT % 2 == 1, "the generator needs an odd height");
+
+    const int CELL_ROWS = (ChunkWorld::CHUNK_HEIGHT - 1) / 2;
+    const int GATE_COLUMNS = ChunkWorld::CHUNK_WIDTH / 4 - 1;   // the centre column has no gates
+
+    // Salts so side, border and layout hashes don't collide
+    const uint64_t SIDE_SALT = 0x51DE51DE51DE51DEull;
+    const uint64_t BORDER_SALT = 0xB0DE2B0DE2B0DE2Bull;
+    const uint64_t LAYOUT_SALT = 0x1A70171A70171A70ull;
+
+    const int SIDE_GATES = 3;
+    const int BORDER_GATES = 2;
+
+    SimRandom hashRandom(uint64_t seed, uint64_t salt, int a, int b) {
+        SimRandom rng;
+        rng.seed(seed ^ salt ^ (static_cast<uint64_t>(static_cast<uint32_t>(a)) * 0x9E3779B97F4A7C15ull)
+                 ^ (static_cast<uint64_t>(static_cast<uint32_t>(b)) * 0xC2B2AE3D27D4EB4Full));
+        return rng;
+    }
+
+    uint64_t pickGates(SimRandom rng, int choices, int picks) {
+        uint64_t bits = 0;
+        for (int i = 0; i < picks; i++) bits |= 1ull << (rng.next() % choices);
+        return bits;
+    }
+
+    int floorDiv(int value, int divisor) {
+        int q = value / divisor;
+        return (value % divisor < 0) ? q - 1 : q;
+    }
+
+    int chunkDistance(glm::ivec2 a, glm::ivec2 b) {
+        return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+    }
+}
+
+ChunkWorld::ChunkWorld(uint64_t world_seed)
+    : seed(world_seed)
+    , budget(DEFAULT_BUDGET)
+    , memoryUsed(0)
+    , maxJobs(std::max(2u, std::thread::hardware_concurrency()))
+{}
+
+ChunkWorld::~ChunkWorld() {
+    for (auto& job : pending) job.second.wait();
+}
+
+glm::ivec2 ChunkWorld::chunkOf(int x, int y) {
+    return glm::ivec2(floorDiv(x, CHUNK_WIDTH), floorDiv(y, CHUNK_HEIGHT));
+}
+
+const ChunkWorld::Chunk* ChunkWorld::getChunk(glm::ivec2 coord) const {
+    auto it = chunks.find(key(coord));
+    return it == chunks.end() ? nullptr : it->second.get();
+}
+
+ChunkWorld::Chunk* ChunkWorld::getChunk(glm::ivec2 coord) {
+    auto it = chunks.find(key(coord));
+    return it == chunks.end() ? nullptr : it->second.get();
+}
+
+TileType ChunkWorld::getTile(int x, int y) const {
+    glm::ivec2 coord = chunkOf(x, y);
+    const Chunk* chunk = getChunk(coord);
+    if (!chunk) return TileType::WALL;
+    return chunk->getTile(x - coord.x * CHUNK_WIDTH, y - coord.y * CHUNK_HEIGHT);
+}
+
+bool ChunkWorld::isWalkable(int x, int y) const {
+    TileType tile = getTile(x, y);
+    return tile == TileType::FLOOR || tile == TileType::PELLET ||
+           tile == TileType::POWER || tile == TileType::DOOR;
+}
+
+int ChunkWorld::eatPellet(int x, int y) {
+    glm::ivec2 coord = chunkOf(x, y);
+    Chunk* chunk = getChunk(coord);
+    if (!chunk) return 0;
+
+    int lx = x - coord.x * CHUNK_WIDTH;
+    int ly = y - coord.y * CHUNK_HEIGHT;
+    uint32_t bit = 1u << lx;
+    int points = 0;
+    if (chunk->pellets[ly] & bit) points = PacMan::PELLET_POINTS;
+    else if (chunk->powers[ly] & bit) points = PacMan::POWER_POINTS;
+    else return 0;
+
+    chunk->pellets[ly] &= ~bit;
+    chunk->powers[ly] &= ~bit;
+    chunk->tiles[ly * CHUNK_WIDTH + lx] = TileType::FLOOR;
+    chunk->pelletVersion++;
+    return points;
+}
+
+void ChunkWorld::update(glm::ivec2 focus_tile) {
+    glm::ivec2 focus = chunkOf(focus_tile.x, focus_tile.y);
+    collect(focus);
+    request(focus);
+    evict(focus);
+    stats.peakBytes = std::max(stats.peakBytes, memoryUsed);
+    stats.peakResident = std::max(stats.peakResident, chunks.size());
+}
+
+void ChunkWorld::prefetch(glm::ivec2 focus_tile) {
+    glm::ivec2 focus = chunkOf(focus_tile.x, focus_tile.y);
+    for (;;) {
+        update(focus_tile);
+        bool ready = true;
+        for (int y = focus.y - LOAD_RADIUS; y <= focus.y + LOAD_RADIUS && ready; y++) {
+            for (int x = focus.x - LOAD_RADIUS; x <= focus.x + LOAD_RADIUS && ready; x++) {
+                ready = getChunk(glm::ivec2(x, y)) != nullptr;
+            }
+        }
+        if (ready) return;
+        if (!pending.empty()) pending.begin()->second.wait();
+    }
+}
+
+void ChunkWorld::collect(glm::ivec2 focus) {
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        std::unique_ptr<Chunk> chunk = it->second.get();
+        it = pending.erase(it);
+
+        // Keep one ring of slack so chunks at the edge don't churn
+        if (chunkDistance(chunk->coord, focus) > LOAD_RADIUS + 1) {
+            stats.discarded++;
+            continue;
+        }
+        memoryUsed += chunk->bytes;
+        stats.generated++;
+        chunks[key(chunk->coord)] = std::move(chunk);
+    }
+}
+
+void ChunkWorld::request(glm::ivec2 focus) {
+    // Nearest ring first, so the chunk Pac-Man is in never waits on far ones
+    for (int ring = 0; ring <= LOAD_RADIUS && pending.size() < maxJobs; ring++) {
+        for (int y = focus.y - ring; y <= focus.y + ring; y++) {
+            for (int x = focus.x - ring; x <= focus.x + ring; x++) {
+                glm::ivec2 coord(x, y);
+                if (chunkDistance(coord, focus) != ring) continue;
+                uint64_t k = key(coord);
+                if (chunks.count(k) || pending.count(k)) continue;
+                if (pending.size() >= maxJobs) return;
+                pending.emplace(k, std::async(std::launch::async, &ChunkWorld::build, seed, coord));
+            }
+        }
+    }
+}
+
+void ChunkWorld::evict(glm::ivec2 focus) {
+    if (memoryUsed <= budget) return;
+
+    // Farthest first; never the chunks update() is keeping loaded
+    order.clear();
+    for (const auto& entry : chunks) {
+        if (chunkDistance(entry.second->coord, focus) > LOAD_RADIUS) order.push_back(entry.first);
+    }
+    std::sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+        return chunkDistance(chunks[a]->coord, focus) > chunkDistance(chunks[b]->coord, focus);
+    });
+    for (uint64_t k : order) {
+        if (memoryUsed <= budget) break;
+        memoryUsed -= chunks[k]->bytes;
+        chunks.erase(k);
+        stats.evicted++;
+    }
+}
+
+std::unique_ptr<ChunkWorld::Chunk> ChunkWorld::build(uint64_t world_seed, glm::ivec2 coord) {
+    auto chunk = std::make_unique<Chunk>();
+    chunk->coord = coord;
+
+    // Side gates belong to the chunk row; bottom/top ones to the border
+    // shared with the chunk below/above
+    MazeGenerator::Gates gates;
+    gates.sides = pickGates(hashRandom(world_seed, SIDE_SALT, coord.y, 0), CELL_ROWS, SIDE_GATES);
+    gates.bottom = pickGates(hashRandom(world_seed, BORDER_SALT, coord.x, coord.y), GATE_COLUMNS, BORDER_GATES);
+    gates.top = pickGates(hashRandom(world_seed, BORDER_SALT, coord.x, coord.y + 1), GATE_COLUMNS, BORDER_GATES);
+
+    MazeGenerator::Params params;
+    params.width = CHUNK_WIDTH;
+    params.height = CHUNK_HEIGHT;
+    MazeGenerator generator(params);
+    SimRandom layout = hashRandom(world_seed, LAYOUT_SALT, coord.x, coord.y);
+    int width = 0;
+    int height = 0;
+    if (!generator.generateTiles(layout.state, gates, width, height, chunk->tiles)) {
+        // Never seen in practice; an open field still joins every gate
+        chunk->tiles.assign(static_cast<size_t>(CHUNK_WIDTH) * CHUNK_HEIGHT, TileType::FLOOR);
+    }
+
+    chunk->pellets.assign(CHUNK_HEIGHT, 0);
+    chunk->powers.assign(CHUNK_HEIGHT, 0);
+    const int originX = coord.x * CHUNK_WIDTH;
+    const int originY = coord.y * CHUNK_HEIGHT;
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int x = 0; x < CHUNK_WIDTH; x++) {
+            TileType tile = chunk->getTile(x, y);
+            glm::vec3 pos = tileToWorld(originX + x, originY + y);
+            if (tile == TileType::WALL) {
+                chunk->mesh.walls.push_back(glm::translate(glm::mat4(1.0f), pos + glm::vec3(0.0f, 0.5f, 0.0f)));
+                continue;
+            }
+            chunk->mesh.floors.push_back(glm::translate(glm::mat4(1.0f), pos));
+            if (tile == TileType::PELLET) chunk->pellets[y] |= 1u << x;
+            if (tile == TileType::POWER) chunk->powers[y] |= 1u << x;
+        }
+    }
+
+    chunk->bytes = sizeof(Chunk)
+                 + chunk->tiles.size() * sizeof(TileType)
+                 + (chunk->pellets.size() + chunk->powers.size()) * sizeof(uint32_t)
+                 + (chunk->mesh.walls.size() + chunk->mesh.floors.size()) * sizeof(glm::mat4);
+    return chunk;
+}
+
+WorldRunner::WorldRunner()
+    : tile(0, 0)
+    , target(0, 0)
+    , dir(Direction::NONE)
+    , buffered(Direction::NONE)
+    , elapsed(0.0f)
+    , moving(false)
+    , score(0)
+    , travelled(0)
+{}
+
+void WorldRunner::reset(glm::ivec2 start) {
+    tile = start;
+    target = start;
+    dir = Direction::NONE;
+    buffered = Direction::NONE;
+    elapsed = 0.0f;
+    moving = false;
+    score = 0;
+    travelled = 0;
+}
+
+glm::vec3 WorldRunner::getWorldPos() const {
+    float t = moving ? std::min(elapsed / MOVE_DURATION, 1.0f) : 0.0f;
+    glm::vec3 pos = glm::mix(ChunkWorld::tileToWorld(tile.x, tile.y), ChunkWorld::tileToWorld(target.x, target.y), t);
+    pos.y = 0.5f;
+    return pos;
+}
+
+bool WorldRunner::tryMove(const ChunkWorld& world, Direction heading) {
+    if (heading == Direction::NONE) return false;
+    glm::ivec2 next = tile + Entity::getDirectionOffset(heading);
+    if (!world.isWalkable(next.x, next.y)) return false;
+    target = next;
+    dir = heading;
+    moving = true;
+    elapsed = 0.0f;
+    return true;
+}
+
+void WorldRunner::step(ChunkWorld& world, float dt, Direction input) {
+    if (input != Direction::NONE) buffered = input;
+
+    if (moving) {
+        elapsed += dt;
+        if (elapsed < MOVE_DURATION) return;
+        tile = target;
+        moving = false;
+        travelled++;
+        score += world.eatPellet(tile.x, tile.y);
+    }
+
+    // Buffered turn if it's open, otherwise keep going
+    if (tryMove(world, buffered)) {
+        buffered = Direction::NONE;
+        return;
+    }
+    tryMove(world, dir);
+}
@@ -0,0 +1,159 @@
+#ifndef CHUNKWORLD_H
+#define CHUNKWORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "maze.h"
+
+/**
+ * Endless maze made of fixed-size chunks, streamed around a focus tile.
+ *
+ * Each chunk is a MazeGenerator maze seeded from the world seed and its
+ * chunk coordinate, with gates in its outer wall that line up with its
+ * neighbours' (side gates are shared by a whole chunk row, bottom/top
+ * gates by the two chunks either side of the border). A chunk owns its
+ * tiles, pellet bits and the instance transforms for its static geometry.
+ *
+ * update() queues every missing chunk within LOAD_RADIUS of the focus,
+ * nearest first, as background jobs that generate and mesh it; finished
+ * chunks are installed on the next update(). Once resident chunks pass
+ * the memory budget, the ones farthest from the focus are dropped along
+ * with their eaten pellets. Memory and per-update work therefore stay
+ * bounded however far Pac-Man runs.
+ *
+ * Tile coordinates are world-wide (any int); tiles of chunks that are not
+ * resident read as walls.
+ */
+class ChunkWorld {
+public:
+    static constexpr int CHUNK_WIDTH = 32;
+    static constexpr int CHUNK_HEIGHT = 31;
+    static constexpr int LOAD_RADIUS = 2;
+    static constexpr size_t DEFAULT_BUDGET = 32u << 20;
+
+    // Static geometry of one chunk, built with it on the job thread
+    struct MeshData {
+        std::vector<glm::mat4> walls;
+        std::vector<glm::mat4> floors;
+    };
+
+    struct Chunk {
+        glm::ivec2 coord;
+        std::vector<TileType> tiles;        // CHUNK_WIDTH * CHUNK_HEIGHT, row-major
+        std::vector<uint32_t> pellets;      // bit per tile, one word per row
+        std::vector<uint32_t> powers;
+        MeshData mesh;                      // until the renderer takes it
+        bool meshTaken = false;
+        unsigned int pelletVersion = 0;     // bumped whenever a pellet is eaten
+        size_t bytes = 0;                   // tiles, bits and mesh (CPU or GPU side)
+
+        TileType getTile(int x, int y) const { return tiles[y * CHUNK_WIDTH + x]; }
+    };
+
+    struct Stats {
+        uint64_t generated = 0;
+        uint64_t evicted = 0;
+        uint64_t discarded = 0;     // finished after drifting out of range
+        size_t peakBytes = 0;
+        size_t peakResident = 0;
+    };
+
+    explicit ChunkWorld(uint64_t seed = 1);
+    ~ChunkWorld();
+
+    ChunkWorld(const ChunkWorld&) = delete;
+    ChunkWorld& operator=(const ChunkWorld&) = delete;
+
+    void setMemoryBudget(size_t bytes) { budget = bytes; }
+    size_t getMemoryBudget() const { return budget; }
+
+    // Install finished chunks, queue missing ones and evict over budget
+    void update(glm::ivec2 focus_tile);
+
+    // update() and wait until every chunk within LOAD_RADIUS is resident
+    void prefetch(glm::ivec2 focus_tile);
+
+    TileType getTile(int x, int y) const;
+    bool isWalkable(int x, int y) const;
+
+    // Remove the pellet at (x, y); returns the points it was worth
+    int eatPellet(int x, int y);
+
+    // Tile centre in world space (tile (0, 0) at the origin, Y up)
+    static glm::vec3 tileToWorld(int x, int y) {
+        return glm::vec3((x + 0.5f) * Maze::TILE_SIZE, 0.0f, (y + 0.5f) * Maze::TILE_SIZE);
+    }
+    static glm::ivec2 chunkOf(int x, int y);
+
+    const Chunk* getChunk(glm::ivec2 coord) const;
+    Chunk* getChunk(glm::ivec2 coord);
+    const std::unordered_map<uint64_t, std::unique_ptr<Chunk>>& getChunks() const { return chunks; }
+
+    size_t getResidentCount() const { return chunks.size(); }
+    size_t getPendingCount() const { return pending.size(); }
+    size_t getMemoryUsed() const { return memoryUsed; }
+    const Stats& getStats() const { return stats; }
+
+    static uint64_t key(glm::ivec2 coord) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.y);
+    }
+
+private:
+    uint64_t seed;
+    size_t budget;
+    size_t memoryUsed;
+    size_t maxJobs;
+    Stats stats;
+    std::unordered_map<uint64_t, std::unique_ptr<Chunk>> chunks;
+    std::unordered_map<uint64_t, std::future<std::unique_ptr<Chunk>>> pending;
+    std::vector<uint64_t> order;    // scratch
+
+    void collect(glm::ivec2 focus);
+    void request(glm::ivec2 focus);
+    void evict(glm::ivec2 focus);
+
+    // Generate and mesh one chunk (runs on a job thread)
+    static std::unique_ptr<Chunk> build(uint64_t seed, glm::ivec2 coord);
+};
+
+/**
+ * Pac-Man on a ChunkWorld for endless mode: tile to tile at his normal
+ * speed, taking a buffered turn as soon as it opens up and eating what
+ * he passes. There are no ghosts or lives.
+ */
+class WorldRunner {
+public:
+    static constexpr float MOVE_DURATION = 0.18f;
+
+    WorldRunner();
+
+    void reset(glm::ivec2 tile);
+    void step(ChunkWorld& world, float dt, Direction input);
+
+    glm::ivec2 getTile() const { return tile; }
+    glm::ivec2 getTarget() const { return target; }    // tile being entered (tile when stopped)
+    glm::vec3 getWorldPos() const;
+    Direction getDirection() const { return dir; }
+    bool isMoving() const { return moving; }
+    int getScore() const { return score; }
+    uint64_t getTilesTravelled() const { return travelled; }
+
+private:
+    glm::ivec2 tile;
+    glm::ivec2 target;
+    Direction dir;
+    Direction buffered;
+    float elapsed;
+    bool moving;
+    int score;
+    uint64_t travelled;
+
+    bool tryMove(const ChunkWorld& world, Direction heading);
+};
+
+#endif // CHUNKWORLD_H
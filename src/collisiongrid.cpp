@@ -0,0 +1,19 @@
+#include "collisiongrid.h"
+
+void CollisionGrid::resize(size_t tile_count) {
+    heads.assign(tile_count, END);
+    touched.clear();
+}
+
+void CollisionGrid::clear() {
+    for (uint32_t tile : touched) heads[tile] = END;
+    touched.clear();
+}
+
+void CollisionGrid::insert(uint32_t tile, int32_t id) {
+    if (tile >= heads.size() || id < 0) return;
+    if (static_cast<size_t>(id) >= links.size()) links.resize(id + 1, END);
+    if (heads[tile] == END) touched.push_back(tile);
+    links[id] = heads[tile];
+    heads[tile] = id;
+}
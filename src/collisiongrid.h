@@ -0,0 +1,39 @@
+#ifndef COLLISIONGRID_H
+#define COLLISIONGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Per-tile spatial hash for entity collisions: each tile holds a linked
+ * list of entity ids threaded through one array. Inserting and clearing
+ * cost O(entities) (only touched tiles are reset), and a lookup only
+ * visits the entities on that tile.
+ */
+class CollisionGrid {
+public:
+    static constexpr int32_t END = -1;
+
+    // Size for a maze of tile_count tiles; empties the grid
+    void resize(size_t tile_count);
+
+    size_t getTileCount() const { return heads.size(); }
+
+    // Remove every entity
+    void clear();
+
+    // Add entity id (any non-negative int) to a tile
+    void insert(uint32_t tile, int32_t id);
+
+    // First entity on a tile (END if none); follow with next()
+    int32_t first(uint32_t tile) const { return tile < heads.size() ? heads[tile] : END; }
+    int32_t next(int32_t id) const { return links[id]; }
+
+private:
+    std::vector<int32_t> heads;       // per tile
+    std::vector<int32_t> links;       // per entity id
+    std::vector<uint32_t> touched;    // tiles with a non-empty list
+};
+
+#endif // COLLISIONGRID_H
@@ -23,7 +23,7 @@ void Entity::update(float delta_time) {
         float t = std::min(move_elapsed / move_duration, 1.0f);
         
         // Smooth interpolation (ease-out)
-        t = 1.0f - (1.0f - t) * (1.0f - t);
+        t = easeOut(t);
         
         // Interpolate position
         world_pos = glm::mix(prev_pos, target_pos, t);
@@ -51,25 +51,32 @@ void Entity::setGridPosition(int x, int y, const Maze& maze) {
 
 bool Entity::tryMove(Direction dir, const Maze& maze) {
     if (is_moving) return false;
-    if (dir == Direction::NONE) return false;
     
-    glm::ivec2 offset = getDirectionOffset(dir);
-    int new_x = grid_x + offset.x;
-    int new_y = grid_y + offset.y;
-    
-    // Check if new position is walkable
-    if (!maze.isWalkable(new_x, new_y)) {
+    // One table read covers walls, bounds, NONE and tunnel wraps
+    uint32_t next = maze.getNeighbour(grid_x, grid_y, dir);
+    if (next == Maze::NO_NEIGHBOUR) {
         return false;
     }
     
+    glm::ivec2 offset = getDirectionOffset(dir);
+    int new_x = static_cast<int>(next % maze.getWidth());
+    int new_y = static_cast<int>(next / maze.getWidth());
+    bool wrapped = (new_x != grid_x + offset.x) || (new_y != grid_y + offset.y);
+    
     // Start movement
     grid_x = new_x;
     grid_y = new_y;
     current_dir = dir;
     
-    prev_pos = world_pos;
     target_pos = maze.gridToWorld(new_x, new_y);
     target_pos.y = 0.5f;
+    if (wrapped) {
+        // Through a tunnel: enter from just outside the far edge
+        prev_pos = target_pos - (maze.gridToWorld(offset.x, offset.y) - maze.gridToWorld(0, 0));
+        world_pos = prev_pos;
+    } else {
+        prev_pos = world_pos;
+    }
     
     is_moving = true;
     move_elapsed = 0.0f;
@@ -77,12 +84,64 @@ bool Entity::tryMove(Direction dir, const Maze& maze) {
     return true;
 }
 
+uint32_t Entity::getPreviousTile(const Maze& maze) const {
+    if (!is_moving) return Maze::NO_NEIGHBOUR;
+    return maze.getNeighbour(grid_x, grid_y, getOppositeDirection(current_dir));
+}
+
+bool Entity::followCorridor(const Maze& maze) {
+    if (is_moving || current_dir == Direction::NONE) return false;
+    
+    Direction next = maze.getJunctionGraph().continueCorridor(grid_x, grid_y, current_dir);
+    if (next == Direction::NONE) return false;
+    
+    return tryMove(next, maze);
+}
+
+void Entity::saveState(EntityState& state) const {
+    state.grid_x = static_cast<int16_t>(grid_x);
+    state.grid_y = static_cast<int16_t>(grid_y);
+    state.current_dir = static_cast<int8_t>(current_dir);
+    state.desired_dir = static_cast<int8_t>(desired_dir);
+    state.is_moving = is_moving;
+    state.move_duration = move_duration;
+    state.move_elapsed = move_elapsed;
+    state.world_pos = world_pos;
+    state.prev_pos = prev_pos;
+    state.target_pos = target_pos;
+}
+
+void Entity::loadState(const EntityState& state) {
+    grid_x = state.grid_x;
+    grid_y = state.grid_y;
+    current_dir = static_cast<Direction>(state.current_dir);
+    desired_dir = static_cast<Direction>(state.desired_dir);
+    is_moving = state.is_moving;
+    move_duration = state.move_duration;
+    move_elapsed = state.move_elapsed;
+    world_pos = state.world_pos;
+    prev_pos = state.prev_pos;
+    target_pos = state.target_pos;
+}
+
 glm::ivec2 Entity::getDirectionOffset(Direction dir) {
+    // Indexed by Direction + 1 so NONE maps to no movement
+    static const glm::ivec2 offsets[5] = {
+        glm::ivec2(0, 0),   // NONE
+        glm::ivec2(0, 1),   // UP
+        glm::ivec2(0, -1),  // DOWN
+        glm::ivec2(-1, 0),  // LEFT
+        glm::ivec2(1, 0)    // RIGHT
+    };
+    return offsets[static_cast<int>(dir) + 1];
+}
+
+Direction Entity::getOppositeDirection(Direction dir) {
     switch (dir) {
-        case Direction::UP:    return glm::ivec2(0, 1);
-        case Direction::DOWN:  return glm::ivec2(0, -1);
-        case Direction::LEFT:  return glm::ivec2(-1, 0);
-        case Direction::RIGHT: return glm::ivec2(1, 0);
-        default:               return glm::ivec2(0, 0);
+        case Direction::UP:    return Direction::DOWN;
+        case Direction::DOWN:  return Direction::UP;
+        case Direction::LEFT:  return Direction::RIGHT;
+        case Direction::RIGHT: return Direction::LEFT;
+        default:               return Direction::NONE;
     }
 }
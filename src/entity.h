@@ -1,6 +1,7 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 /**
@@ -14,6 +15,22 @@ enum class Direction {
     RIGHT = 3   // +X
 };
 
+/**
+ * Plain-data copy of an Entity's movement state, for snapshots
+ */
+struct EntityState {
+    int16_t grid_x;
+    int16_t grid_y;
+    int8_t current_dir;
+    int8_t desired_dir;
+    bool is_moving;
+    float move_duration;
+    float move_elapsed;
+    glm::vec3 world_pos;
+    glm::vec3 prev_pos;
+    glm::vec3 target_pos;
+};
+
 /**
  * Base Entity class for all game entities (Pac-Man, Ghosts).
  * Handles tile-based movement with smooth interpolation.
@@ -52,9 +69,28 @@ public:
     // Try to move in a direction (returns true if movement started)
     bool tryMove(Direction dir, const class Maze& maze);
     
+    // Tile index the entity is moving away from (Maze::NO_NEIGHBOUR when
+    // standing still); grid_x/grid_y already name the tile it is entering
+    uint32_t getPreviousTile(const class Maze& maze) const;
+    
+    // Keep going along a corridor of the maze's junction graph. Returns
+    // false at junctions (or when stopped), where a decision is needed.
+    bool followCorridor(const class Maze& maze);
+    
+    // Copy movement state out of / back into the entity
+    void saveState(EntityState& state) const;
+    void loadState(const EntityState& state);
+    
     // Get direction offset
     static glm::ivec2 getDirectionOffset(Direction dir);
     
+    // Movement curve over a step: fraction of the move done after
+    // progress t in [0, 1] (ease-out)
+    static float easeOut(float t) { return 1.0f - (1.0f - t) * (1.0f - t); }
+    
+    // Get the reverse of a direction
+    static Direction getOppositeDirection(Direction dir);
+    
 protected:
     // Called when arriving at a new tile
     virtual void onTileReached() {}
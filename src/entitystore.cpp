@@ -0,0 +1,218 @@
+#include "entitystore.h"
+#include "collisiongrid.h"
+#include "influencemap.h"
+#include "maze.h"
+#include "threadpool.h"
+#include <algorithm>
+
+size_t EntityStore::add(GhostType ghost_type, int x, int y, const Maze& maze) {
+    glm::vec3 world = maze.gridToWorld(x, y);
+
+    gridX.push_back(x);
+    gridY.push_back(y);
+    targetTileX.push_back(0);
+    targetTileY.push_back(0);
+    worldX.push_back(world.x);
+    worldZ.push_back(world.z);
+    prevX.push_back(world.x);
+    prevZ.push_back(world.z);
+    targetX.push_back(world.x);
+    targetZ.push_back(world.z);
+    moveElapsed.push_back(0.0f);
+    moveDuration.push_back(Ghost::getMoveDuration(ghost_type));
+    frightenedTime.push_back(0.0f);
+    dir.push_back(static_cast<int8_t>(Direction::NONE));
+    moving.push_back(0);
+    type.push_back(static_cast<uint8_t>(ghost_type));
+    mode.push_back(static_cast<uint8_t>(GhostMode::CHASE));
+    eaten.push_back(0);
+    return gridX.size() - 1;
+}
+
+void EntityStore::clear() {
+    gridX.clear(); gridY.clear();
+    targetTileX.clear(); targetTileY.clear();
+    worldX.clear(); worldZ.clear();
+    prevX.clear(); prevZ.clear();
+    targetX.clear(); targetZ.clear();
+    moveElapsed.clear(); moveDuration.clear();
+    frightenedTime.clear();
+    dir.clear(); moving.clear(); type.clear(); mode.clear(); eaten.clear();
+}
+
+void EntityStore::think(const Maze& maze, glm::ivec2 pacman_pos, SimRandom& rng, ThreadPool* pool) {
+    const size_t count = size();
+    const JunctionGraph& graph = maze.getJunctionGraph();
+
+    // Small counts: decide and move in one pass
+    if (!pool || pool->getThreadCount() == 1 || count < parallelThreshold) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t random = rng.next();
+            if (eaten[i] || moving[i]) continue;
+            MoveCommand move = decide(i, maze, graph, pacman_pos, random);
+            if (move.next != Maze::NO_NEIGHBOUR) applyMove(move, maze);
+        }
+        return;
+    }
+
+    // Draw every entity's random number up front, in the serial order, so
+    // decisions don't depend on how the work is split
+    randoms.resize(count);
+    for (size_t i = 0; i < count; i++) randoms[i] = rng.next();
+
+    workerMoves.resize(pool->getThreadCount());
+    for (auto& buffer : workerMoves) buffer.clear();
+
+    pool->parallelFor(count, THINK_GRAIN, [&](size_t begin, size_t end, unsigned int worker) {
+        std::vector<MoveCommand>& out = workerMoves[worker];
+        for (size_t i = begin; i < end; i++) {
+            if (eaten[i] || moving[i]) continue;
+            MoveCommand move = decide(i, maze, graph, pacman_pos, randoms[i]);
+            if (move.next != Maze::NO_NEIGHBOUR) out.push_back(move);
+        }
+    });
+
+    // Merge in entity order and apply
+    moves.clear();
+    for (const auto& buffer : workerMoves) moves.insert(moves.end(), buffer.begin(), buffer.end());
+    std::sort(moves.begin(), moves.end(),
+              [](const MoveCommand& a, const MoveCommand& b) { return a.entity < b.entity; });
+    for (const MoveCommand& move : moves) applyMove(move, maze);
+}
+
+EntityStore::MoveCommand EntityStore::decide(size_t i, const Maze& maze, const JunctionGraph& graph,
+                                             glm::ivec2 pacman_pos, uint32_t random) {
+    MoveCommand move{static_cast<uint32_t>(i), Direction::NONE, Maze::NO_NEIGHBOUR};
+
+    // Between junctions the only legal move is onward (Entity::followCorridor)
+    Direction current = static_cast<Direction>(dir[i]);
+    if (current != Direction::NONE) {
+        move.dir = graph.continueCorridor(gridX[i], gridY[i], current);
+        move.next = maze.getNeighbour(gridX[i], gridY[i], move.dir);
+        if (move.next != Maze::NO_NEIGHBOUR) return move;
+    }
+
+    GhostMode ghostMode = static_cast<GhostMode>(mode[i]);
+    glm::ivec2 grid(gridX[i], gridY[i]);
+    glm::ivec2 target = Ghost::chooseTarget(maze, static_cast<GhostType>(type[i]), ghostMode, grid, pacman_pos,
+                                            glm::ivec2(targetTileX[i], targetTileY[i]));
+    targetTileX[i] = target.x;
+    targetTileY[i] = target.y;
+
+    move.dir = (ghostMode == GhostMode::FRIGHTENED && influence)
+        ? Ghost::chooseFleeDirection(maze, grid, current, *influence, random)
+        : Ghost::chooseDirection(maze, grid, current, ghostMode, target, random);
+    move.next = maze.getNeighbour(gridX[i], gridY[i], move.dir);
+    return move;
+}
+
+void EntityStore::thinkOne(size_t i, const Maze& maze, const JunctionGraph& graph, glm::ivec2 pacman_pos,
+                           uint32_t random) {
+    MoveCommand move = decide(i, maze, graph, pacman_pos, random);
+    if (move.next != Maze::NO_NEIGHBOUR) applyMove(move, maze);
+}
+
+void EntityStore::thinkFallback(size_t i, const Maze& maze, const JunctionGraph& graph, uint32_t random) {
+    MoveCommand move{static_cast<uint32_t>(i), Direction::NONE, Maze::NO_NEIGHBOUR};
+
+    // Corridors have one answer anyway; only junctions get the cheap rule
+    Direction current = static_cast<Direction>(dir[i]);
+    if (current != Direction::NONE) {
+        move.dir = graph.continueCorridor(gridX[i], gridY[i], current);
+        move.next = maze.getNeighbour(gridX[i], gridY[i], move.dir);
+    }
+    if (move.next == Maze::NO_NEIGHBOUR) {
+        move.dir = Ghost::chooseFallback(maze, glm::ivec2(gridX[i], gridY[i]), current, random);
+        move.next = maze.getNeighbour(gridX[i], gridY[i], move.dir);
+    }
+    if (move.next != Maze::NO_NEIGHBOUR) applyMove(move, maze);
+}
+
+void EntityStore::move(float dt) {
+    const size_t count = size();
+    float* wx = worldX.data();
+    float* wz = worldZ.data();
+    float* elapsedOut = moveElapsed.data();
+    uint8_t* movingOut = moving.data();
+    const float* px = prevX.data();
+    const float* pz = prevZ.data();
+    const float* tx = targetX.data();
+    const float* tz = targetZ.data();
+    const float* duration = moveDuration.data();
+    const uint8_t* frozen = eaten.data();
+
+    // Entity::update for every entity, with selects instead of branches
+    for (size_t i = 0; i < count; i++) {
+        bool active = movingOut[i] && !frozen[i];
+        float elapsed = elapsedOut[i] + (active ? dt : 0.0f);
+        float t = Entity::easeOut(std::min(elapsed / duration[i], 1.0f));
+        bool arrived = active && elapsed >= duration[i];
+
+        // Scalar glm::mix matches the vec3 mix in Entity::update bit for bit
+        float x = glm::mix(px[i], tx[i], t);
+        float z = glm::mix(pz[i], tz[i], t);
+        wx[i] = arrived ? tx[i] : (active ? x : wx[i]);
+        wz[i] = arrived ? tz[i] : (active ? z : wz[i]);
+        elapsedOut[i] = arrived ? 0.0f : elapsed;
+        movingOut[i] = static_cast<uint8_t>(active ? !arrived : movingOut[i]);
+    }
+}
+
+void EntityStore::tick(float dt) {
+    const uint8_t frightened = static_cast<uint8_t>(GhostMode::FRIGHTENED);
+    const uint8_t chase = static_cast<uint8_t>(GhostMode::CHASE);
+    for (size_t i = 0; i < size(); i++) {
+        bool counting = !eaten[i] && mode[i] == frightened;
+        float left = frightenedTime[i] - (counting ? dt : 0.0f);
+        frightenedTime[i] = left;
+        mode[i] = (counting && left <= 0.0f) ? chase : mode[i];
+    }
+}
+
+void EntityStore::frighten(float duration) {
+    for (size_t i = 0; i < size(); i++) {
+        if (eaten[i]) continue;
+        mode[i] = static_cast<uint8_t>(GhostMode::FRIGHTENED);
+        frightenedTime[i] = duration;
+        moveDuration[i] *= 1.5f;
+    }
+}
+
+void EntityStore::fillGrid(CollisionGrid& grid, int maze_width) const {
+    grid.clear();
+    for (size_t i = 0; i < size(); i++) {
+        if (eaten[i]) continue;
+        grid.insert(static_cast<uint32_t>(gridY[i] * maze_width + gridX[i]), static_cast<int32_t>(i));
+    }
+}
+
+void EntityStore::applyMove(const MoveCommand& move, const Maze& maze) {
+    // Entity::tryMove with the neighbour lookup already done
+    size_t i = move.entity;
+    glm::ivec2 offset = Entity::getDirectionOffset(move.dir);
+    int newX = static_cast<int>(move.next % maze.getWidth());
+    int newY = static_cast<int>(move.next / maze.getWidth());
+    bool wrapped = (newX != gridX[i] + offset.x) || (newY != gridY[i] + offset.y);
+
+    gridX[i] = newX;
+    gridY[i] = newY;
+    dir[i] = static_cast<int8_t>(move.dir);
+
+    glm::vec3 target = maze.gridToWorld(newX, newY);
+    targetX[i] = target.x;
+    targetZ[i] = target.z;
+    if (wrapped) {
+        // Through a tunnel: enter from just outside the far edge
+        glm::vec3 step = maze.gridToWorld(offset.x, offset.y) - maze.gridToWorld(0, 0);
+        prevX[i] = target.x - step.x;
+        prevZ[i] = target.z - step.z;
+        worldX[i] = prevX[i];
+        worldZ[i] = prevZ[i];
+    } else {
+        prevX[i] = worldX[i];
+        prevZ[i] = worldZ[i];
+    }
+
+    moving[i] = 1;
+    moveElapsed[i] = 0.0f;
+}
@@ -0,0 +1,108 @@
+#ifndef ENTITYSTORE_H
+#define ENTITYSTORE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ghost.h"
+#include "simrandom.h"
+
+class Maze;
+class JunctionGraph;
+class CollisionGrid;
+class ThreadPool;
+class InfluenceMap;
+
+/**
+ * Structure-of-arrays ghost store for swarm levels. Each field of Ghost
+ * lives in its own array and the per-tick work runs as system loops over
+ * all entities instead of virtual update() calls:
+ *
+ *   think()  - junction decisions (Ghost::chooseTarget/chooseDirection),
+ *              spread over a ThreadPool for large counts
+ *   move()   - Entity::update's ease-out interpolation, branch-free
+ *   tick()   - frightened timers
+ *
+ * World positions are kept as separate x/z arrays (y is constant), so the
+ * interpolation loop vectorises.
+ */
+class EntityStore {
+public:
+    // Spawn a ghost on a tile; returns its index
+    size_t add(GhostType type, int x, int y, const Maze& maze);
+
+    void clear();
+    size_t size() const { return gridX.size(); }
+
+    // Systems, in the order Simulation runs them for its ghosts. With a
+    // pool and at least getParallelThreshold() entities, think() decides
+    // in parallel into per-worker buffers and then applies the moves in
+    // entity order, so the result is the same on any thread count.
+    void think(const Maze& maze, glm::ivec2 pacman_pos, SimRandom& rng, ThreadPool* pool = nullptr);
+    void move(float dt);
+    void tick(float dt);
+
+    // Per-entity steps for schedulers that pick the order themselves
+    // (AiScheduler). Only idle entities (not eaten, not mid-move) decide;
+    // thinkFallback uses Ghost::chooseFallback instead of the full rules.
+    bool isIdle(size_t i) const { return !eaten[i] && !moving[i]; }
+    void thinkOne(size_t i, const Maze& maze, const JunctionGraph& graph, glm::ivec2 pacman_pos, uint32_t random);
+    void thinkFallback(size_t i, const Maze& maze, const JunctionGraph& graph, uint32_t random);
+
+    // Frighten every ghost that is not eaten (as Ghost::setFrightened)
+    void frighten(float duration);
+
+    // Bucket live ghosts by tile index for collision queries
+    void fillGrid(CollisionGrid& grid, int maze_width) const;
+
+    // Frightened ghosts flee by this map (nullptr: by target, as before).
+    // The caller keeps it updated for Pac-Man's position.
+    void setInfluence(const InfluenceMap* map) { influence = map; }
+
+    // Fewer entities than this think serially (tune per machine)
+    void setParallelThreshold(size_t count) { parallelThreshold = count; }
+    size_t getParallelThreshold() const { return parallelThreshold; }
+
+    static constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 1024;
+    static constexpr size_t THINK_GRAIN = 256;
+
+    glm::vec3 getWorldPos(size_t i) const { return glm::vec3(worldX[i], WORLD_Y, worldZ[i]); }
+
+    static constexpr float WORLD_Y = 0.5f;
+
+    // Per entity
+    std::vector<int32_t> gridX, gridY;
+    std::vector<int32_t> targetTileX, targetTileY;
+    std::vector<float> worldX, worldZ;
+    std::vector<float> prevX, prevZ;
+    std::vector<float> targetX, targetZ;
+    std::vector<float> moveElapsed, moveDuration;
+    std::vector<float> frightenedTime;
+    std::vector<int8_t> dir;
+    std::vector<uint8_t> moving;
+    std::vector<uint8_t> type;
+    std::vector<uint8_t> mode;
+    std::vector<uint8_t> eaten;
+
+private:
+    struct MoveCommand {
+        uint32_t entity;
+        Direction dir;
+        uint32_t next;   // destination tile (Maze::NO_NEIGHBOUR = stay put)
+    };
+
+    size_t parallelThreshold = DEFAULT_PARALLEL_THRESHOLD;
+    const InfluenceMap* influence = nullptr;
+    std::vector<uint32_t> randoms;
+    std::vector<std::vector<MoveCommand>> workerMoves;
+    std::vector<MoveCommand> moves;
+
+    // Move for idle entity i; writes only entity i's target tile
+    MoveCommand decide(size_t i, const Maze& maze, const JunctionGraph& graph, glm::ivec2 pacman_pos,
+                       uint32_t random);
+
+    // Start a decided move
+    void applyMove(const MoveCommand& move, const Maze& maze);
+};
+
+#endif // ENTITYSTORE_H
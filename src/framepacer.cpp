@@ -0,0 +1,151 @@
+#include "framepacer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+FramePacer::FramePacer()
+    : mode(PacingMode::VSYNC)
+    , targetFps(120.0)
+    , idleFps(30.0)
+    , backgroundFps(10.0)
+    , idle(false)
+    , background(false)
+    , frameTimes(WINDOW_SIZE, 0.0)
+    , frameIndex(0)
+    , frameCount(0)
+    , sleepMean(1.5)
+    , sleepVariance(0.25)
+{
+    lastFrame = Clock::now();
+    deadline = lastFrame;
+    lastReport = lastFrame;
+}
+
+void FramePacer::setMode(PacingMode newMode) {
+    mode = newMode;
+    deadline = Clock::now();
+    std::cout << "Frame pacing: " << getModeName(mode) << std::endl;
+}
+
+void FramePacer::cycleMode() {
+    switch (mode) {
+        case PacingMode::VSYNC:    setMode(PacingMode::CAPPED); break;
+        case PacingMode::CAPPED:   setMode(PacingMode::UNCAPPED); break;
+        case PacingMode::UNCAPPED: setMode(PacingMode::VSYNC); break;
+    }
+}
+
+const char* FramePacer::getModeName(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::VSYNC:    return "vsync";
+        case PacingMode::CAPPED:   return "capped";
+        case PacingMode::UNCAPPED: return "uncapped";
+        default:                   return "unknown";
+    }
+}
+
+double FramePacer::getActiveCap() const {
+    // Background and idle throttles apply in every mode: vsync alone does
+    // not stop a hidden window or a static menu from spinning the GPU.
+    if (background) return backgroundFps;
+
+    double cap = (mode == PacingMode::CAPPED) ? targetFps : 0.0;
+    if (idle) {
+        cap = (cap > 0.0) ? std::min(cap, idleFps) : idleFps;
+    }
+    return cap;
+}
+
+void FramePacer::endFrame() {
+    double cap = getActiveCap();
+
+    if (cap > 0.0) {
+        auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / cap));
+        deadline += period;
+
+        // Fell more than a frame behind (hitch, breakpoint): resync instead
+        // of rushing several frames out back-to-back.
+        Clock::time_point now = Clock::now();
+        if (deadline < now - period) {
+            deadline = now;
+        }
+        waitUntil(deadline);
+    } else {
+        deadline = Clock::now();
+    }
+
+    Clock::time_point now = Clock::now();
+    recordFrame(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+    lastFrame = now;
+}
+
+void FramePacer::waitUntil(Clock::time_point target) {
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    // Sleep while the remaining time comfortably exceeds the pessimistic
+    // cost of one sleep (mean + one standard deviation), then spin.
+    for (;;) {
+        double remaining = Ms(target - Clock::now()).count();
+        if (remaining <= sleepMean + std::sqrt(sleepVariance)) break;
+
+        Clock::time_point start = Clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        double observed = Ms(Clock::now() - start).count();
+
+        // Exponential moving mean/variance so the estimate follows changes
+        // in OS timer resolution
+        const double alpha = 1.0 / 16.0;
+        double delta = observed - sleepMean;
+        sleepMean += alpha * delta;
+        sleepVariance = (1.0 - alpha) * (sleepVariance + alpha * delta * delta);
+    }
+
+    while (Clock::now() < target) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordFrame(double ms) {
+    frameTimes[frameIndex] = ms;
+    frameIndex = (frameIndex + 1) % WINDOW_SIZE;
+    frameCount = std::min(frameCount + 1, WINDOW_SIZE);
+}
+
+double FramePacer::getMeanFrameMs() const {
+    if (frameCount == 0) return 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < frameCount; ++i) sum += frameTimes[i];
+    return sum / static_cast<double>(frameCount);
+}
+
+double FramePacer::getStdDevFrameMs() const {
+    if (frameCount < 2) return 0.0;
+    double mean = getMeanFrameMs();
+    double sumSq = 0.0;
+    for (size_t i = 0; i < frameCount; ++i) {
+        double d = frameTimes[i] - mean;
+        sumSq += d * d;
+    }
+    return std::sqrt(sumSq / static_cast<double>(frameCount - 1));
+}
+
+double FramePacer::getMaxFrameMs() const {
+    double maxMs = 0.0;
+    for (size_t i = 0; i < frameCount; ++i) maxMs = std::max(maxMs, frameTimes[i]);
+    return maxMs;
+}
+
+void FramePacer::report() {
+    Clock::time_point now = Clock::now();
+    if (std::chrono::duration<double>(now - lastReport).count() < REPORT_INTERVAL) return;
+    lastReport = now;
+
+    double mean = getMeanFrameMs();
+    std::cout << "Frame pacing [" << getModeName(mode)
+              << (background ? ", background" : (idle ? ", idle" : "")) << "]: "
+              << mean << " ms avg (" << (mean > 0.0 ? 1000.0 / mean : 0.0) << " fps), "
+              << getStdDevFrameMs() << " ms stddev, "
+              << getMaxFrameMs() << " ms max" << std::endl;
+}
@@ -0,0 +1,90 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <vector>
+
+/**
+ * Frame pacing modes.
+ */
+enum class PacingMode {
+    VSYNC,      // Let the swap interval block (swap interval 1)
+    CAPPED,     // Fixed frame cap with hybrid sleep/spin deadline
+    UNCAPPED    // No limit (benchmarking only)
+};
+
+/**
+ * FramePacer limits how often the main loop presents a frame.
+ * Besides the selected mode it throttles idle screens (menus) and
+ * unfocused/iconified windows, and keeps frame-time statistics.
+ */
+class FramePacer {
+public:
+    FramePacer();
+
+    // Mode selection
+    void setMode(PacingMode mode);
+    PacingMode getMode() const { return mode; }
+    void cycleMode();
+
+    // Frame rate limits (frames per second)
+    void setTargetFps(double fps) { targetFps = fps; }
+    void setIdleFps(double fps) { idleFps = fps; }
+    void setBackgroundFps(double fps) { backgroundFps = fps; }
+
+    // Throttle hints, updated once per frame by the main loop
+    void setIdle(bool value) { idle = value; }
+    void setBackground(bool value) { background = value; }
+
+    // Swap interval the window should use for the current mode
+    int getSwapInterval() const { return mode == PacingMode::VSYNC ? 1 : 0; }
+
+    // Call once per frame after presenting; sleeps until the next deadline
+    void endFrame();
+
+    // Frame-time statistics over the recent window (milliseconds)
+    double getMeanFrameMs() const;
+    double getStdDevFrameMs() const;
+    double getMaxFrameMs() const;
+
+    // Print statistics every few seconds
+    void report();
+
+    static const char* getModeName(PacingMode mode);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PacingMode mode;
+    double targetFps;
+    double idleFps;
+    double backgroundFps;
+    bool idle;
+    bool background;
+
+    Clock::time_point lastFrame;
+    Clock::time_point deadline;
+    Clock::time_point lastReport;
+
+    // Rolling window of frame times
+    std::vector<double> frameTimes;
+    size_t frameIndex;
+    size_t frameCount;
+
+    // Running estimate of how long a 1 ms sleep really takes
+    double sleepMean;
+    double sleepVariance;
+
+    // Current frame cap in fps (0 = no software cap)
+    double getActiveCap() const;
+
+    // Sleep in 1 ms slices while safe, then spin to the deadline
+    void waitUntil(Clock::time_point target);
+
+    void recordFrame(double ms);
+
+    static constexpr size_t WINDOW_SIZE = 240;
+    static constexpr double REPORT_INTERVAL = 5.0;
+};
+
+#endif // FRAMEPACER_H
@@ -1,6 +1,7 @@
 #include "ghost.h"
+#include "influencemap.h"
 #include "maze.h"
-#include <glm/gtc/matrix_transform.hpp>
+#include "pathtable.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -16,12 +17,7 @@ Ghost::Ghost(GhostType type)
     , spawn_y(1)
 {
     color = getGhostColor(type);
-    switch (type) {
-        case GhostType::BLINKY: move_duration = 0.20f; break;
-        case GhostType::PINKY:  move_duration = 0.24f; break;
-        case GhostType::INKY:   move_duration = 0.26f; break;
-        case GhostType::CLYDE:  move_duration = 0.28f; break;
-    }
+    move_duration = getMoveDuration(type);
 }
 
 glm::vec3 Ghost::getGhostColor(GhostType type) {
@@ -64,72 +60,118 @@ void Ghost::respawn(const Maze& maze, int x, int y) {
     frightenedTime = 0.0f;
     current_dir = Direction::NONE;
     
-    switch (ghost_type) {
-        case GhostType::BLINKY: move_duration = 0.20f; break;
-        case GhostType::PINKY:  move_duration = 0.24f; break;
-        case GhostType::INKY:   move_duration = 0.26f; break;
-        case GhostType::CLYDE:  move_duration = 0.28f; break;
-    }
+    move_duration = getMoveDuration(ghost_type);
+}
+
+void Ghost::saveState(GhostState& state) const {
+    Entity::saveState(state.entity);
+    state.target_x = static_cast<int16_t>(target_tile.x);
+    state.target_y = static_cast<int16_t>(target_tile.y);
+    state.frightenedTime = frightenedTime;
+    state.mode = static_cast<uint8_t>(mode);
+    state.isEaten = isEaten;
+}
+
+void Ghost::loadState(const GhostState& state) {
+    Entity::loadState(state.entity);
+    target_tile = glm::ivec2(state.target_x, state.target_y);
+    frightenedTime = state.frightenedTime;
+    mode = static_cast<GhostMode>(state.mode);
+    isEaten = state.isEaten;
 }
 
-void Ghost::updateAI(const Maze& maze, const glm::ivec2& pacman_pos) {
+void Ghost::updateAI(const Maze& maze, const glm::ivec2& pacman_pos, uint32_t random,
+                     const InfluenceMap* influence) {
     if (isEaten || is_moving) return;
     
+    // Between junctions the only legal move is onward, so skip the search
+    if (followCorridor(maze)) return;
+    
+    glm::ivec2 grid(grid_x, grid_y);
+    target_tile = chooseTarget(maze, ghost_type, mode, grid, pacman_pos, target_tile);
+    
+    Direction best_dir = (mode == GhostMode::FRIGHTENED && influence)
+        ? chooseFleeDirection(maze, grid, current_dir, *influence, random)
+        : chooseDirection(maze, grid, current_dir, mode, target_tile, random);
+    if (best_dir != Direction::NONE) {
+        tryMove(best_dir, maze);
+    }
+}
+
+glm::ivec2 Ghost::chooseTarget(const Maze& maze, GhostType type, GhostMode mode,
+                               glm::ivec2 grid, glm::ivec2 pacman_pos, glm::ivec2 previous) {
     if (mode == GhostMode::FRIGHTENED) {
-        // Run away from Pac-Man
-        target_tile = glm::ivec2(grid_x * 2 - pacman_pos.x, grid_y * 2 - pacman_pos.y);
+        // Run away from Pac-Man: with path tables, maximise true path
+        // length from him; otherwise head for the mirrored tile
+        if (maze.getPathTable() && maze.getPathTable()->getIndex(pacman_pos.x, pacman_pos.y) >= 0) {
+            return pacman_pos;
+        }
+        return grid * 2 - pacman_pos;
     }
-    else if (mode == GhostMode::CHASE) {
-        switch (ghost_type) {
+    if (mode == GhostMode::CHASE) {
+        switch (type) {
             case GhostType::BLINKY:
-                target_tile = pacman_pos;
-                break;
+                return pacman_pos;
             case GhostType::PINKY:
-                target_tile = pacman_pos + glm::ivec2(4, 0);
-                break;
+                return pacman_pos + glm::ivec2(4, 0);
             case GhostType::INKY:
-                target_tile = pacman_pos + glm::ivec2(-3, 3);
-                break;
+                return pacman_pos + glm::ivec2(-3, 3);
             case GhostType::CLYDE:
                 {
-                    int dist = manhattanDistance(glm::ivec2(grid_x, grid_y), pacman_pos);
-                    target_tile = (dist > 8) ? pacman_pos : glm::ivec2(1, 1);
+                    const PathTable* table = maze.getPathTable();
+                    int dist = table ? table->getDistance(grid.x, grid.y, pacman_pos.x, pacman_pos.y) : -1;
+                    if (dist < 0) dist = manhattanDistance(grid, pacman_pos);
+                    return (dist > 8) ? pacman_pos : glm::ivec2(1, 1);
                 }
-                break;
         }
     }
-    
-    Direction best_dir = findBestDirection(maze);
-    if (best_dir != Direction::NONE) {
-        tryMove(best_dir, maze);
-    }
+    return previous;
 }
 
-Direction Ghost::findBestDirection(const Maze& maze) {
+Direction Ghost::chooseDirection(const Maze& maze, glm::ivec2 grid, Direction current, GhostMode mode,
+                                 glm::ivec2 target, uint32_t random) {
     Direction directions[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
     
     Direction best_dir = Direction::NONE;
     int best_dist = (mode == GhostMode::FRIGHTENED) ? -999999 : 999999;
     
-    Direction opposite = Direction::NONE;
-    switch (current_dir) {
-        case Direction::UP:    opposite = Direction::DOWN; break;
-        case Direction::DOWN:  opposite = Direction::UP; break;
-        case Direction::LEFT:  opposite = Direction::RIGHT; break;
-        case Direction::RIGHT: opposite = Direction::LEFT; break;
-        default: break;
-    }
+    Direction opposite = getOppositeDirection(current);
+    
+    // Walkable targets use true path length from the precomputed tables,
+    // or on large mazes the cluster hierarchy. Without either, Pac-Man's
+    // tile uses the shared distance field; anything else falls back to
+    // Manhattan
+    const PathTable* table = maze.getPathTable();
+    const PathHierarchy* hierarchy = maze.getHierarchy();
+    bool useTable = table && table->getIndex(target.x, target.y) >= 0;
+    bool useHierarchy = !useTable && hierarchy && maze.isWalkable(target.x, target.y);
+    bool useField = !table && !useHierarchy && (target == maze.getFieldTarget());
     
-    for (Direction dir : directions) {
+    // Frightened ghosts start the scan at a random direction, so ties
+    // between equally distant escapes are broken by the seeded RNG
+    int first = (mode == GhostMode::FRIGHTENED) ? static_cast<int>(random & 3u) : 0;
+    
+    for (int i = 0; i < 4; i++) {
+        Direction dir = directions[(first + i) & 3];
         if (dir == opposite) continue;
         
-        glm::ivec2 offset = getDirectionOffset(dir);
-        int new_x = grid_x + offset.x;
-        int new_y = grid_y + offset.y;
+        uint32_t next = maze.getNeighbour(grid.x, grid.y, dir);
+        if (next == Maze::NO_NEIGHBOUR) continue;
         
-        if (!maze.isWalkable(new_x, new_y)) continue;
+        int new_x = static_cast<int>(next % maze.getWidth());
+        int new_y = static_cast<int>(next / maze.getWidth());
         
-        int dist = manhattanDistance(glm::ivec2(new_x, new_y), target_tile);
+        int dist;
+        if (useTable) {
+            dist = table->getDistance(new_x, new_y, target.x, target.y);
+        } else if (useHierarchy) {
+            dist = hierarchy->getDistance(maze, new_x, new_y, target.x, target.y);
+        } else if (useField) {
+            dist = maze.getFieldDistance(new_x, new_y);
+        } else {
+            dist = manhattanDistance(glm::ivec2(new_x, new_y), target);
+        }
+        if (dist < 0) continue;
         
         if (mode == GhostMode::FRIGHTENED) {
             if (dist > best_dist) { best_dist = dist; best_dir = dir; }
@@ -138,30 +180,72 @@ Direction Ghost::findBestDirection(const Maze& maze) {
         }
     }
     
+    // Dead end: reversing is the only way out
+    if (best_dir == Direction::NONE) {
+        best_dir = opposite;
+    }
     return best_dir;
 }
 
-int Ghost::manhattanDistance(glm::ivec2 a, glm::ivec2 b) {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+Direction Ghost::chooseFleeDirection(const Maze& maze, glm::ivec2 grid, Direction current,
+                                     const InfluenceMap& influence, uint32_t random) {
+    Direction directions[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    Direction opposite = getOppositeDirection(current);
+    
+    // Same random scan start as chooseDirection, so ties split by seed
+    Direction best_dir = Direction::NONE;
+    float best_score = 0.0f;
+    int first = static_cast<int>(random & 3u);
+    for (int i = 0; i < 4; i++) {
+        Direction dir = directions[(first + i) & 3];
+        if (dir == opposite) continue;
+        
+        uint32_t next = maze.getNeighbour(grid.x, grid.y, dir);
+        if (next == Maze::NO_NEIGHBOUR) continue;
+        
+        float score = influence.sample(static_cast<int>(next % maze.getWidth()), static_cast<int>(next / maze.getWidth()));
+        if (best_dir == Direction::NONE || score < best_score) {
+            best_score = score;
+            best_dir = dir;
+        }
+    }
+    
+    // Dead end: reversing is the only way out
+    if (best_dir == Direction::NONE) {
+        best_dir = opposite;
+    }
+    return best_dir;
 }
 
-void Ghost::onTileReached() {
+Direction Ghost::chooseFallback(const Maze& maze, glm::ivec2 grid, Direction current, uint32_t random) {
+    if (current != Direction::NONE && maze.getNeighbour(grid.x, grid.y, current) != Maze::NO_NEIGHBOUR) {
+        return current;
+    }
+    
+    Direction directions[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    Direction opposite = getOppositeDirection(current);
+    int first = static_cast<int>(random & 3u);
+    for (int i = 0; i < 4; i++) {
+        Direction dir = directions[(first + i) & 3];
+        if (dir == opposite) continue;
+        if (maze.getNeighbour(grid.x, grid.y, dir) != Maze::NO_NEIGHBOUR) return dir;
+    }
+    return opposite;
 }
 
-void Ghost::render(Shader& shader) {
-    if (isEaten) return;
-    
-    glm::vec3 render_color = (mode == GhostMode::FRIGHTENED) ? FRIGHTENED_COLOR : color;
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, world_pos);
-    model = glm::scale(model, glm::vec3(0.8f));
-    
-    shader.setMat4("model", model);
-    mesh.draw();
+float Ghost::getMoveDuration(GhostType type) {
+    switch (type) {
+        case GhostType::BLINKY: return 0.20f;
+        case GhostType::PINKY:  return 0.24f;
+        case GhostType::INKY:   return 0.26f;
+        case GhostType::CLYDE:  return 0.28f;
+        default:                return 0.20f;
+    }
+}
+
+int Ghost::manhattanDistance(glm::ivec2 a, glm::ivec2 b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
 }
 
-void Ghost::createMesh() {
-    mesh = createCube(color);
-    frightenedMesh = createCube(FRIGHTENED_COLOR);
+void Ghost::onTileReached() {
 }
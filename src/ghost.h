@@ -1,9 +1,8 @@
 #ifndef GHOST_H
 #define GHOST_H
 
+#include <cstdint>
 #include "entity.h"
-#include "mesh.h"
-#include "shader.h"
 
 enum class GhostMode {
     CHASE,
@@ -18,6 +17,15 @@ enum class GhostType {
     CLYDE = 3
 };
 
+struct GhostState {
+    EntityState entity;
+    int16_t target_x;
+    int16_t target_y;
+    float frightenedTime;
+    uint8_t mode;
+    bool isEaten;
+};
+
 class Ghost : public Entity {
 public:
     Ghost(GhostType type);
@@ -31,23 +39,40 @@ public:
     float frightenedTime;
     
     void update(float delta_time) override;
-    void updateAI(const class Maze& maze, const glm::ivec2& pacman_pos);
-    void render(Shader& shader);
-    void createMesh();
+    // random breaks ties between equally good moves (deterministic per seed).
+    // With an influence map, frightened ghosts flee by it instead of by target.
+    void updateAI(const class Maze& maze, const glm::ivec2& pacman_pos, uint32_t random = 0,
+                  const class InfluenceMap* influence = nullptr);
     
     void setFrightened(float duration);
     void respawn(const class Maze& maze, int x, int y);
     
+    void saveState(GhostState& state) const;
+    void loadState(const GhostState& state);
+    
     static glm::vec3 getGhostColor(GhostType type);
+    
+    // Rules shared with the batch simulator: where a ghost aims, which way
+    // it turns at a junction, and how long one tile step takes
+    static glm::ivec2 chooseTarget(const class Maze& maze, GhostType type, GhostMode mode,
+                                   glm::ivec2 grid, glm::ivec2 pacman_pos, glm::ivec2 previous);
+    static Direction chooseDirection(const class Maze& maze, glm::ivec2 grid, Direction current,
+                                     GhostMode mode, glm::ivec2 target, uint32_t random);
+    // Frightened move by influence map: the non-reversing exit with the
+    // lowest InfluenceMap::sample
+    static Direction chooseFleeDirection(const class Maze& maze, glm::ivec2 grid, Direction current,
+                                         const class InfluenceMap& influence, uint32_t random);
+    // Cheap stand-in for chooseDirection when the AI budget runs out: keep
+    // heading, else a random exit that doesn't reverse
+    static Direction chooseFallback(const class Maze& maze, glm::ivec2 grid, Direction current, uint32_t random);
+    static float getMoveDuration(GhostType type);
+    static int manhattanDistance(glm::ivec2 a, glm::ivec2 b);
+    
     static constexpr glm::vec3 FRIGHTENED_COLOR{0.3f, 0.3f, 1.0f};
     
 private:
-    Mesh mesh;
-    Mesh frightenedMesh;
     int spawn_x, spawn_y;
     
-    Direction findBestDirection(const class Maze& maze);
-    int manhattanDistance(glm::ivec2 a, glm::ivec2 b);
     void onTileReached() override;
 };
 
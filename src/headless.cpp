@@ -0,0 +1,565 @@
+/**
+ * Headless Pac-Man runner: plays full games with the simulation rules
+ * only (no window, GL or audio) as fast as the CPU allows.
+ *
+ * Usage: pacman_headless [--level path] [--games N] [--max-ticks N]
+ *                        [--bot greedy|random|mcts | --script file] [--seed N]
+ *                        [--budget ms] [--threads N]
+ *                        [--record file] [--verbose] [--generate]
+ *        pacman_headless --replay file [--level path] [--seek tick]
+ *        pacman_headless --batch N [--threads N] [--level path | --generate] [--max-ticks N] [--seed N]
+ *        pacman_headless --swarm N [--threads N] [--ai-threshold N] [--ai-budget us] [--ai-view N]
+ *                        [--level path] [--max-ticks N] [--seed N]
+ *        pacman_headless --gen-bench N [--threads N] [--seed N]
+ *        pacman_headless --world N [--budget-mb N] [--seed N]
+ *        pacman_headless --convert out.pmlv [--level path]
+ *
+ * --generate plays procedurally generated levels (seeded from --seed, a
+ * new one per game) instead of the level file.
+ *
+ * --convert validates the level and writes it in the binary format,
+ * which --level and the game load like a text level.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aischeduler.h"
+#include "batchsim.h"
+#include "chunkworld.h"
+#include "collisiongrid.h"
+#include "entitystore.h"
+#include "influencemap.h"
+#include "levelfile.h"
+#include "mazegen.h"
+#include "mctsbot.h"
+#include "replay.h"
+#include "simulation.h"
+#include "simbot.h"
+#include "threadpool.h"
+
+namespace {
+    const int TICK_RATE = 120;
+
+    struct Options {
+        std::string levelPath = "levels/level1.txt";
+        std::string bot = "greedy";
+        std::string scriptPath;
+        std::string recordPath;
+        std::string replayPath;
+        std::string convertPath;
+        uint64_t seekTick = 0;
+        int games = 1;
+        int batch = 0;
+        int swarm = 0;
+        int genBench = 0;
+        uint64_t worldTicks = 0;
+        size_t worldBudget = ChunkWorld::DEFAULT_BUDGET;
+        bool generate = false;
+        size_t aiThreshold = EntityStore::DEFAULT_PARALLEL_THRESHOLD;
+        double aiBudgetMicros = 0.0;
+        int aiView = 12;    // tiles either side of Pac-Man counted as on screen
+        unsigned int threads = 0;
+        double budgetMs = 10.0;
+        uint64_t maxTicks = static_cast<uint64_t>(TICK_RATE) * 60 * 10;
+        uint32_t seed = 1;
+        bool verbose = false;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: pacman_headless [--level path] [--games N] [--max-ticks N]\n"
+                  << "                       [--bot greedy|random|mcts | --script file] [--seed N]\n"
+                  << "                       [--budget ms] [--threads N]\n"
+                  << "                       [--record file] [--verbose] [--generate]\n"
+                  << "       pacman_headless --replay file [--level path] [--seek tick]\n"
+                  << "       pacman_headless --batch N [--threads N] [--level path | --generate] [--max-ticks N] [--seed N]\n"
+                  << "       pacman_headless --swarm N [--threads N] [--ai-threshold N] [--ai-budget us] [--ai-view N]\n"
+                  << "                       [--level path] [--max-ticks N] [--seed N]\n"
+                  << "       pacman_headless --gen-bench N [--threads N] [--seed N]\n"
+                  << "       pacman_headless --world N [--budget-mb N] [--seed N]\n"
+                  << "       pacman_headless --convert out.pmlv [--level path]" << std::endl;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--level" && hasValue)          options.levelPath = argv[++i];
+            else if (arg == "--games" && hasValue)     options.games = std::atoi(argv[++i]);
+            else if (arg == "--max-ticks" && hasValue) options.maxTicks = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--bot" && hasValue)       options.bot = argv[++i];
+            else if (arg == "--script" && hasValue)    options.scriptPath = argv[++i];
+            else if (arg == "--seed" && hasValue)      options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--record" && hasValue)    options.recordPath = argv[++i];
+            else if (arg == "--replay" && hasValue)    options.replayPath = argv[++i];
+            else if (arg == "--convert" && hasValue)   options.convertPath = argv[++i];
+            else if (arg == "--seek" && hasValue)      options.seekTick = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--batch" && hasValue)     options.batch = std::atoi(argv[++i]);
+            else if (arg == "--swarm" && hasValue)     options.swarm = std::atoi(argv[++i]);
+            else if (arg == "--gen-bench" && hasValue) options.genBench = std::atoi(argv[++i]);
+            else if (arg == "--generate")              options.generate = true;
+            else if (arg == "--world" && hasValue)     options.worldTicks = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--budget-mb" && hasValue) options.worldBudget = std::strtoull(argv[++i], nullptr, 10) << 20;
+            else if (arg == "--ai-threshold" && hasValue) options.aiThreshold = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--ai-budget" && hasValue) options.aiBudgetMicros = std::atof(argv[++i]);
+            else if (arg == "--ai-view" && hasValue)   options.aiView = std::atoi(argv[++i]);
+            else if (arg == "--budget" && hasValue)    options.budgetMs = std::atof(argv[++i]);
+            else if (arg == "--threads" && hasValue)   options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+            else if (arg == "--verbose")               options.verbose = true;
+            else return false;
+        }
+        return options.games > 0 && options.batch >= 0 && options.swarm >= 0 && options.genBench >= 0;
+    }
+
+    std::unique_ptr<InputSource> createInput(const Options& options) {
+        if (!options.scriptPath.empty()) {
+            auto script = std::make_unique<ScriptedInput>();
+            if (!script->load(options.scriptPath)) return nullptr;
+            return script;
+        }
+        if (options.bot == "greedy") return std::make_unique<GreedyBot>();
+        if (options.bot == "random") return std::make_unique<RandomBot>(options.seed);
+        if (options.bot == "mcts") return std::make_unique<MctsBot>(options.budgetMs, options.threads, options.seed);
+
+        std::cerr << "ERROR::HEADLESS: Unknown bot: " << options.bot << std::endl;
+        return nullptr;
+    }
+
+    // Play a recording back at full speed and check it ends bit-exact
+    int runReplay(const Options& options) {
+        ReplayLog log;
+        if (!log.load(options.replayPath)) return 1;
+
+        ReplayPlayer player;
+        if (!player.start(log, options.levelPath)) return 1;
+        if (options.seekTick > log.totalTicks) {
+            std::cerr << "ERROR::HEADLESS: Can't seek to tick " << options.seekTick
+                      << ", the replay ends at tick " << log.totalTicks << std::endl;
+            return 1;
+        }
+
+        std::streambuf* coutBuffer = std::cout.rdbuf();
+        if (!options.verbose) std::cout.rdbuf(nullptr);
+
+        auto start = std::chrono::steady_clock::now();
+        bool seeked = options.seekTick == 0 || player.seek(options.seekTick);
+        uint64_t seekTicks = player.getTick();
+        double seekMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        while (seeked && player.step()) {
+            player.getSimulation().events.clear();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout.rdbuf(coutBuffer);
+        std::cout.clear();
+        if (!seeked) {
+            std::cerr << "ERROR::HEADLESS: Seek to tick " << options.seekTick << " failed" << std::endl;
+            return 1;
+        }
+
+        const Simulation& sim = player.getSimulation();
+        std::cout << "Replay: " << log.inputs.size() << " inputs, " << log.totalTicks << " ticks, seed " << log.seed << std::endl;
+        if (options.seekTick > 0) {
+            std::cout << "Seek to tick " << seekTicks << " took " << seekMs << " ms" << std::endl;
+        }
+        std::cout << "Final score " << sim.pacman.score << ", lives " << sim.pacman.lives
+                  << " in " << seconds << " s ("
+                  << static_cast<uint64_t>(log.totalTicks / (seconds > 0.0 ? seconds : 1e-9)) << " ticks/s)" << std::endl;
+
+        if (!player.verify()) {
+            std::cout << "DESYNC: final state checksum does not match the recording" << std::endl;
+            return 2;
+        }
+        std::cout << "Replay verified: final state matches" << std::endl;
+        return 0;
+    }
+
+    // Step N games in lockstep through BatchSim with random inputs and
+    // report the aggregate throughput
+    int runBatch(const Options& options) {
+        BatchSim batch;
+        if (options.generate) {
+            Maze level;
+            MazeGenerator generator;
+            if (!generator.generate(options.seed, level) || !batch.init(level, options.batch, options.threads)) return 1;
+        } else if (!batch.init(options.levelPath, options.batch, options.threads)) {
+            return 1;
+        }
+
+        size_t count = static_cast<size_t>(batch.size());
+        std::vector<uint64_t> seeds(count);
+        std::vector<SimRandom> inputRng(count);
+        for (size_t i = 0; i < count; i++) {
+            seeds[i] = options.seed + i;
+            inputRng[i].seed(~seeds[i]);
+        }
+        batch.reset(seeds.data());
+
+        std::vector<int8_t> actions(count, static_cast<int8_t>(Direction::NONE));
+        std::vector<float> rewards(count);
+        std::vector<uint8_t> dones(count);
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t ticks = 0;
+        size_t finished = 0;
+        while (ticks < options.maxTicks && finished < count) {
+            // A new random direction roughly every quarter second
+            for (size_t i = 0; i < count; i++) {
+                uint32_t roll = inputRng[i].next();
+                if ((roll & 31u) == 0) actions[i] = static_cast<int8_t>((roll >> 5) & 3u);
+            }
+            batch.step(actions.data(), rewards.data(), dones.data());
+            ticks++;
+
+            finished = 0;
+            for (size_t i = 0; i < count; i++) finished += dones[i];
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        long long totalScore = 0;
+        for (size_t i = 0; i < count; i++) totalScore += batch.getScore(static_cast<int>(i));
+
+        std::cout << count << " batched games, " << ticks << " steps, " << finished << " finished, average score "
+                  << (count ? totalScore / static_cast<long long>(count) : 0) << std::endl;
+        std::cout << static_cast<uint64_t>(ticks * count / (seconds > 0.0 ? seconds : 1e-9)) << " game ticks/s" << std::endl;
+        return 0;
+    }
+
+    // Stress the entity store: the greedy bot plays a normal game while N
+    // extra ghosts (harmless here; contacts are only counted) chase it
+    int runSwarm(const Options& options) {
+        Simulation sim;
+        if (!sim.init(options.levelPath)) return 1;
+        sim.setSeed(options.seed);
+        sim.newGame();
+        sim.setLogging(false);
+        const Maze& maze = sim.maze;
+
+        SimRandom rng;
+        rng.seed(options.seed);
+        EntityStore swarm;
+        while (swarm.size() < static_cast<size_t>(options.swarm)) {
+            int x = static_cast<int>(rng.next() % maze.getWidth());
+            int y = static_cast<int>(rng.next() % maze.getHeight());
+            if (!maze.isWalkable(x, y)) continue;
+            swarm.add(static_cast<GhostType>(swarm.size() % 4), x, y, maze);
+        }
+
+        swarm.setParallelThreshold(options.aiThreshold);
+        ThreadPool pool(options.threads);
+
+        // With a budget the scheduler replaces the parallel think
+        AiScheduler scheduler;
+        scheduler.setBudget(options.aiBudgetMicros);
+        const glm::ivec2 viewHalf(options.aiView, options.aiView);
+
+        // Power pellets frighten the swarm too; it flees by one shared map
+        InfluenceMap influence;
+        influence.build(maze, maze.getInfo().ghostSpawns, LevelInfo::GHOST_COUNT);
+        swarm.setInfluence(&influence);
+        float swarmFrightened = 0.0f;
+        float lastPowerTime = 0.0f;
+
+        CollisionGrid grid;
+        grid.resize(static_cast<size_t>(maze.getWidth()) * maze.getHeight());
+
+        GreedyBot bot;
+        const float dt = 1.0f / TICK_RATE;
+        uint64_t contacts = 0;
+        uint64_t ticks = 0;
+        double swarmSeconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (ticks < options.maxTicks && !sim.gameOver) {
+            sim.step(dt, bot.getInput(sim, ticks));
+            sim.events.clear();
+
+            auto swarmStart = std::chrono::steady_clock::now();
+            glm::ivec2 pacmanPos(sim.pacman.grid_x, sim.pacman.grid_y);
+            if (sim.pacman.powerTime > lastPowerTime) {
+                swarm.frighten(PacMan::POWER_DURATION);
+                swarmFrightened = PacMan::POWER_DURATION;
+            }
+            lastPowerTime = sim.pacman.powerTime;
+            swarmFrightened -= dt;
+            if (swarmFrightened > 0.0f) influence.update(maze, pacmanPos, sim.pacman.current_dir);
+            // The game's camera follows Pac-Man; a square around him stands in for it
+            if (options.aiView > 0) scheduler.setView(pacmanPos - viewHalf, pacmanPos + viewHalf);
+            if (options.aiBudgetMicros > 0.0) scheduler.think(swarm, maze, pacmanPos, rng);
+            else swarm.think(maze, pacmanPos, rng, &pool);
+            swarm.move(dt);
+            swarm.tick(dt);
+            swarm.fillGrid(grid, maze.getWidth());
+            uint32_t pacmanTile = static_cast<uint32_t>(pacmanPos.y * maze.getWidth() + pacmanPos.x);
+            for (int32_t id = grid.first(pacmanTile); id != CollisionGrid::END; id = grid.next(id)) contacts++;
+            swarmSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - swarmStart).count();
+            ticks++;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << swarm.size() << " swarm ghosts on " << pool.getThreadCount() << " threads, "
+                  << ticks << " ticks in " << seconds << " s, " << contacts << " contacts" << std::endl;
+        std::cout << static_cast<uint64_t>(ticks / (swarmSeconds > 0.0 ? swarmSeconds : 1e-9)) << " swarm ticks/s ("
+                  << static_cast<uint64_t>(ticks * swarm.size() / (swarmSeconds > 0.0 ? swarmSeconds : 1e-9))
+                  << " ghost updates/s)" << std::endl;
+        if (options.aiBudgetMicros > 0.0) {
+            const AiScheduler::Stats& ai = scheduler.getStats();
+            std::cout << "AI budget " << options.aiBudgetMicros << " us: " << ai.decisions << " decisions, "
+                      << ai.fallbacks << " fallbacks (" << ai.visibleFallbacks << " on screen), " << ai.overruns << "/" << ai.ticks << " ticks over budget, worst "
+                      << ai.worstMicros << " us" << std::endl;
+        }
+        return 0;
+    }
+
+    // Generate N mazes on the thread pool and report the throughput
+    int runGenBench(const Options& options) {
+        ThreadPool pool(options.threads);
+        MazeGenerator::Params params;
+        std::vector<Maze> mazes;
+
+        auto start = std::chrono::steady_clock::now();
+        MazeGenerator::generateMany(params, options.seed, static_cast<size_t>(options.genBench), mazes, pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        long long walkable = 0;
+        long long junctions = 0;
+        int failed = 0;
+        for (const Maze& maze : mazes) {
+            if (maze.getWidth() == 0) {
+                failed++;
+                continue;
+            }
+            walkable += maze.getJunctionGraph().getWalkableCount();
+            junctions += static_cast<long long>(maze.getJunctionGraph().getNodes().size());
+        }
+        int built = options.genBench - failed;
+
+        std::cout << options.genBench << " mazes (" << params.width << "x" << params.height << ") on "
+                  << pool.getThreadCount() << " threads in " << seconds << " s, " << failed << " failed" << std::endl;
+        std::cout << static_cast<uint64_t>(options.genBench / (seconds > 0.0 ? seconds : 1e-9)) << " mazes/s, "
+                  << (built ? walkable / built : 0) << " walkable tiles and "
+                  << (built ? junctions / built : 0) << " junctions on average" << std::endl;
+        return 0;
+    }
+
+    // Shortest path over the loaded chunks from start to the nearest tile
+    // a chunk further east (or the easternmost one reachable), as steps
+    std::vector<Direction> planEastward(const ChunkWorld& world, glm::ivec2 start) {
+        const int span = 2 * ChunkWorld::LOAD_RADIUS + 1;
+        glm::ivec2 chunk = ChunkWorld::chunkOf(start.x, start.y);
+        glm::ivec2 origin((chunk.x - ChunkWorld::LOAD_RADIUS) * ChunkWorld::CHUNK_WIDTH,
+                          (chunk.y - ChunkWorld::LOAD_RADIUS) * ChunkWorld::CHUNK_HEIGHT);
+        const int w = span * ChunkWorld::CHUNK_WIDTH;
+        const int h = span * ChunkWorld::CHUNK_HEIGHT;
+
+        std::vector<int8_t> from(static_cast<size_t>(w) * h, -1);
+        std::vector<int> queue;
+        int first = (start.y - origin.y) * w + (start.x - origin.x);
+        from[first] = 4;
+        queue.push_back(first);
+        int best = first;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int index = queue[head];
+            int x = index % w;
+            int y = index / w;
+            if (x > best % w) best = index;
+            if (origin.x + x >= start.x + ChunkWorld::CHUNK_WIDTH) break;
+            for (int d = 0; d < 4; d++) {
+                glm::ivec2 next = glm::ivec2(x, y) + Entity::getDirectionOffset(static_cast<Direction>(d));
+                if (next.x < 0 || next.y < 0 || next.x >= w || next.y >= h) continue;
+                int n = next.y * w + next.x;
+                if (from[n] >= 0 || !world.isWalkable(origin.x + next.x, origin.y + next.y)) continue;
+                from[n] = static_cast<int8_t>(d);
+                queue.push_back(n);
+            }
+        }
+
+        std::vector<Direction> steps;
+        for (int index = best; index != first;) {
+            Direction d = static_cast<Direction>(from[index]);
+            steps.push_back(d);
+            glm::ivec2 back = Entity::getDirectionOffset(Entity::getOppositeDirection(d));
+            index += back.y * w + back.x;
+        }
+        std::reverse(steps.begin(), steps.end());
+        return steps;
+    }
+
+    // Endless mode for N ticks: Pac-Man heads east through the streamed
+    // chunk world; reports how far he got and what stayed resident
+    int runWorld(const Options& options) {
+        ChunkWorld world(options.seed);
+        world.setMemoryBudget(options.worldBudget);
+        WorldRunner runner;
+        const glm::ivec2 start(1, 1);
+        world.prefetch(start);
+        runner.reset(start);
+
+        const float dt = 1.0f / TICK_RATE;
+        std::vector<Direction> path;
+        size_t pathStep = 0;
+        glm::ivec2 planned(start.x - 1, start.y);
+        Direction input = Direction::NONE;
+        double worstUpdateMs = 0.0;
+        auto begin = std::chrono::steady_clock::now();
+        for (uint64_t tick = 0; tick < options.worldTicks; tick++) {
+            // Queue the turn for the tile being entered
+            glm::ivec2 next = runner.getTarget();
+            if (next != planned) {
+                if (pathStep >= path.size() || next != planned + Entity::getDirectionOffset(path[pathStep - 1])) {
+                    path = planEastward(world, next);
+                    pathStep = 0;
+                }
+                planned = next;
+                input = pathStep < path.size() ? path[pathStep++] : Direction::NONE;
+            }
+            runner.step(world, dt, input);
+
+            auto updateStart = std::chrono::steady_clock::now();
+            world.update(runner.getTile());
+            worstUpdateMs = std::max(worstUpdateMs, std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - updateStart).count());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        const ChunkWorld::Stats& stats = world.getStats();
+        glm::ivec2 chunk = ChunkWorld::chunkOf(runner.getTile().x, runner.getTile().y);
+        // Ticks run far faster than real time, so Pac-Man often waits at
+        // the edge of the loaded area; his pace shows how far ahead of a
+        // real-time run the streaming stays
+        double pace = runner.getTilesTravelled() * WorldRunner::MOVE_DURATION / (seconds > 0.0 ? seconds : 1e-9);
+        std::cout << "Endless run: " << options.worldTicks << " ticks in " << seconds << " s, "
+                  << runner.getTilesTravelled() << " tiles travelled (" << pace << "x real-time pace), now in chunk ("
+                  << chunk.x << ", " << chunk.y << "), score " << runner.getScore() << std::endl;
+        std::cout << "Chunks: " << stats.generated << " generated, " << stats.evicted << " evicted, "
+                  << stats.discarded << " discarded, " << world.getResidentCount() << " resident (peak "
+                  << stats.peakResident << "), " << (stats.peakBytes >> 10) << " KB peak of "
+                  << (world.getMemoryBudget() >> 10) << " KB budget" << std::endl;
+        std::cout << "Worst streaming update " << worstUpdateMs << " ms" << std::endl;
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    if (!options.replayPath.empty()) {
+        return runReplay(options);
+    }
+    if (options.batch > 0) {
+        return runBatch(options);
+    }
+    if (options.swarm > 0) {
+        return runSwarm(options);
+    }
+    if (options.genBench > 0) {
+        return runGenBench(options);
+    }
+    if (options.worldTicks > 0) {
+        return runWorld(options);
+    }
+    if (!options.convertPath.empty()) {
+        return LevelFile::convert(options.levelPath, options.convertPath) ? 0 : 1;
+    }
+
+    std::unique_ptr<InputSource> input = createInput(options);
+    if (!input) return 1;
+
+    Simulation sim;
+    sim.setSeed(options.seed);
+
+    // Generated levels: the next one is built on a background thread
+    // while the current game plays
+    MazeGenerator::Params levelParams;
+    std::future<Maze> nextLevel;
+    if (options.generate) {
+        nextLevel = MazeGenerator::generateAsync(levelParams, options.seed);
+    } else if (!sim.init(options.levelPath)) {
+        return 1;
+    }
+
+    ReplayLog recording;
+    uint64_t levelHash = options.generate ? 0 : ReplayLog::hashLevel(options.levelPath);
+
+    // Per-tick game chatter dominates run time; mute it unless asked
+    std::streambuf* coutBuffer = std::cout.rdbuf();
+    const float dt = 1.0f / TICK_RATE;
+
+    uint64_t totalTicks = 0;
+    int cleared = 0;
+    long long totalScore = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int game = 0; game < options.games; game++) {
+        if (options.generate) {
+            if (!sim.init(nextLevel.get())) {
+                std::cerr << "ERROR::HEADLESS: Level generation failed" << std::endl;
+                return 1;
+            }
+            if (game + 1 < options.games) {
+                nextLevel = MazeGenerator::generateAsync(levelParams, options.seed + game + 1);
+            }
+        }
+        if (!options.verbose) std::cout.rdbuf(nullptr);
+
+        sim.newGame();
+        input->reset();
+        recording.begin(sim.getSeed(), levelHash, TICK_RATE);
+
+        uint64_t tick = 0;
+        while (!sim.gameOver && tick < options.maxTicks) {
+            Direction dir = input->getInput(sim, tick);
+            recording.record(tick, dir);
+            sim.step(dt, dir);
+            sim.events.clear();
+            tick++;
+        }
+        recording.finish(sim);
+
+        std::cout.rdbuf(coutBuffer);
+        std::cout.clear();
+
+        totalTicks += tick;
+        totalScore += sim.pacman.score;
+        if (sim.levelCleared) cleared++;
+
+        std::cout << "Game " << (game + 1) << ": score " << sim.pacman.score
+                  << ", lives " << sim.pacman.lives
+                  << ", " << (sim.levelCleared ? "cleared" : sim.gameOver ? "game over" : "timed out")
+                  << " after " << tick << " ticks" << std::endl;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The last game's recording
+    if (!options.recordPath.empty() && recording.save(options.recordPath)) {
+        std::cout << "Recorded " << recording.inputs.size() << " inputs to " << options.recordPath << std::endl;
+    }
+
+    std::cout << "\n" << options.games << " games, " << totalTicks << " ticks in " << seconds << " s ("
+              << static_cast<uint64_t>(totalTicks / (seconds > 0.0 ? seconds : 1e-9)) << " ticks/s, "
+              << (totalTicks / static_cast<double>(TICK_RATE)) / (seconds > 0.0 ? seconds : 1e-9)
+              << "x real time)" << std::endl;
+    std::cout << "Mean score " << (totalScore / options.games)
+              << ", cleared " << cleared << "/" << options.games << std::endl;
+
+    if (const MctsBot* mcts = dynamic_cast<const MctsBot*>(input.get())) {
+        const MctsBot::Stats& stats = mcts->getStats();
+        std::cout << "Search: " << stats.decisions << " decisions, " << stats.nodes << " nodes, "
+                  << stats.rollouts << " rollouts, " << static_cast<uint64_t>(mcts->getNodesPerSecond())
+                  << " nodes/s, " << static_cast<uint64_t>(stats.simTicks / (stats.seconds > 0.0 ? stats.seconds : 1e-9))
+                  << " sim ticks/s" << std::endl;
+    }
+    return 0;
+}
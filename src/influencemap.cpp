@@ -0,0 +1,191 @@
+#include "influencemap.h"
+#include "maze.h"
+#include <algorithm>
+#include <deque>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+InfluenceMap::InfluenceMap()
+    : width(0)
+    , height(0)
+    , stride(0)
+    , rowsWrap(false)
+    , columnsWrap(false)
+    , lastPos(-1, -1)
+    , lastHeading(Direction::NONE)
+    , window{0, 0, 0, 0}
+{}
+
+void InfluenceMap::build(const Maze& maze, const glm::ivec2* home_tiles, int home_count) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    stride = (width + 2 + 7) & ~7;
+    size_t cells = static_cast<size_t>(height + 2) * stride;
+
+    mask.assign(cells, 0.0f);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (maze.isWalkable(x, y)) mask[index(x, y)] = 1.0f;
+        }
+    }
+
+    // Open edges wrap: the border cell past one edge mirrors the tile on
+    // the other
+    wrapCopies.clear();
+    rowsWrap = false;
+    columnsWrap = false;
+    for (int y = 0; y < height; y++) {
+        if (maze.getNeighbour(0, y, Direction::LEFT) == static_cast<uint32_t>(y * width + width - 1)) {
+            wrapCopies.push_back(static_cast<uint32_t>(index(-1, y)));
+            wrapCopies.push_back(static_cast<uint32_t>(index(width - 1, y)));
+            wrapCopies.push_back(static_cast<uint32_t>(index(width, y)));
+            wrapCopies.push_back(static_cast<uint32_t>(index(0, y)));
+            rowsWrap = true;
+        }
+    }
+    for (int x = 0; x < width; x++) {
+        if (maze.getNeighbour(x, 0, Direction::DOWN) == static_cast<uint32_t>((height - 1) * width + x)) {
+            wrapCopies.push_back(static_cast<uint32_t>(index(x, -1)));
+            wrapCopies.push_back(static_cast<uint32_t>(index(x, height - 1)));
+            wrapCopies.push_back(static_cast<uint32_t>(index(x, height)));
+            wrapCopies.push_back(static_cast<uint32_t>(index(x, 0)));
+            columnsWrap = true;
+        }
+    }
+
+    // Home field: breadth-first from the spawns. Each tile gets its
+    // parent's value times HOME_DECAY, the same product diffusing to a
+    // fixed point would reach, in one visit per tile.
+    std::vector<uint32_t> wrapSource(cells, 0);
+    for (size_t k = 0; k < wrapCopies.size(); k += 2) wrapSource[wrapCopies[k]] = wrapCopies[k + 1];
+
+    home.assign(cells, 0.0f);
+    std::vector<uint8_t> visited(cells, 0);
+    std::deque<uint32_t> open;
+    for (int i = 0; i < home_count; i++) {
+        const glm::ivec2& tile = home_tiles[i];
+        if (tile.x < 0 || tile.x >= width || tile.y < 0 || tile.y >= height) continue;
+        uint32_t cell = static_cast<uint32_t>(index(tile.x, tile.y));
+        if (visited[cell]) continue;
+        visited[cell] = 1;
+        home[cell] = 1.0f;
+        open.push_back(cell);
+    }
+    const uint32_t offsets[4] = {1u, static_cast<uint32_t>(-1), static_cast<uint32_t>(stride),
+                                 static_cast<uint32_t>(-stride)};
+    while (!open.empty()) {
+        uint32_t cell = open.front();
+        open.pop_front();
+        float value = home[cell] * HOME_DECAY;
+        for (uint32_t offset : offsets) {
+            uint32_t next = cell + offset;
+            if (wrapSource[next] != 0) next = wrapSource[next];
+            if (visited[next] || mask[next] == 0.0f) continue;
+            visited[next] = 1;
+            home[next] = value;
+            open.push_back(next);
+        }
+    }
+
+    seeds.assign(cells, 0.0f);
+    seeded.clear();
+    danger.assign(cells, 0.0f);
+    scratch.assign(cells, 0.0f);
+    window = {0, 0, 0, 0};
+    lastPos = glm::ivec2(-1, -1);
+    lastHeading = Direction::NONE;
+}
+
+void InfluenceMap::update(const Maze& maze, glm::ivec2 pacman_pos, Direction heading) {
+    if (!isBuilt() || (pacman_pos == lastPos && heading == lastHeading)) return;
+    lastPos = pacman_pos;
+    lastHeading = heading;
+
+    for (uint32_t i : seeded) seeds[i] = 0.0f;
+    seeded.clear();
+    clearWindow();
+    if (pacman_pos.x < 0 || pacman_pos.x >= width || pacman_pos.y < 0 || pacman_pos.y >= height) return;
+
+    // Pac-Man's tile, then the tiles he is about to enter
+    uint32_t tile = static_cast<uint32_t>(pacman_pos.y * width + pacman_pos.x);
+    float strength = 1.0f;
+    for (int step = 0; step <= LOOKAHEAD; step++) {
+        uint32_t i = static_cast<uint32_t>(index(static_cast<int>(tile % width), static_cast<int>(tile / width)));
+        seeds[i] = std::max(seeds[i], strength);
+        seeded.push_back(i);
+
+        if (heading == Direction::NONE) break;
+        tile = maze.getNeighbour(tile, heading);
+        if (tile == Maze::NO_NEIGHBOUR) break;
+        strength *= LOOKAHEAD_FALLOFF;
+    }
+
+    // Everything the passes can reach, plus a ring that stays zero. A
+    // window running over a tunnel edge covers the whole row or column,
+    // since danger comes back in on the far side.
+    const int reach = LOOKAHEAD + DANGER_PASSES;
+    window = {pacman_pos.x - reach, pacman_pos.y - reach, pacman_pos.x + reach + 1, pacman_pos.y + reach + 1};
+    if (rowsWrap && (window.x0 < 0 || window.x1 > width)) {
+        window.x0 = 0;
+        window.x1 = width;
+    }
+    if (columnsWrap && (window.y0 < 0 || window.y1 > height)) {
+        window.y0 = 0;
+        window.y1 = height;
+    }
+    window.x0 = std::max(window.x0, 0);
+    window.y0 = std::max(window.y0, 0);
+    window.x1 = std::min(window.x1, width);
+    window.y1 = std::min(window.y1, height);
+
+    for (int pass = 0; pass < DANGER_PASSES; pass++) {
+        diffuse(danger, scratch, seeds, DANGER_DECAY, window);
+        danger.swap(scratch);
+    }
+}
+
+void InfluenceMap::clearWindow() {
+    for (int y = window.y0; y < window.y1; y++) {
+        size_t begin = index(window.x0, y);
+        size_t end = index(window.x1, y);
+        std::fill(danger.begin() + begin, danger.begin() + end, 0.0f);
+        std::fill(scratch.begin() + begin, scratch.begin() + end, 0.0f);
+    }
+    window = {0, 0, 0, 0};
+}
+
+void InfluenceMap::diffuse(std::vector<float>& in, std::vector<float>& out, const std::vector<float>& seed,
+                           float decay, const Window& area) const {
+    for (size_t k = 0; k < wrapCopies.size(); k += 2) in[wrapCopies[k]] = in[wrapCopies[k + 1]];
+
+    // Tiles outside the window are zero in both buffers and stay that way
+    const size_t rowStep = static_cast<size_t>(stride);
+    const float* src = in.data();
+    const float* walk = mask.data();
+    const float* fixed = seed.data();
+    float* dst = out.data();
+
+    for (int y = area.y0; y < area.y1; y++) {
+        size_t i = index(area.x0, y);
+        const size_t end = index(area.x1, y);
+#if defined(__AVX2__)
+        const __m256 scale = _mm256_set1_ps(decay);
+        for (; i + 8 <= end; i += 8) {
+            __m256 best = _mm256_loadu_ps(src + i);
+            best = _mm256_max_ps(best, _mm256_loadu_ps(src + i - 1));
+            best = _mm256_max_ps(best, _mm256_loadu_ps(src + i + 1));
+            best = _mm256_max_ps(best, _mm256_loadu_ps(src + i - rowStep));
+            best = _mm256_max_ps(best, _mm256_loadu_ps(src + i + rowStep));
+            __m256 spread = _mm256_mul_ps(_mm256_mul_ps(best, scale), _mm256_loadu_ps(walk + i));
+            _mm256_storeu_ps(dst + i, _mm256_max_ps(spread, _mm256_loadu_ps(fixed + i)));
+        }
+#endif
+        for (; i < end; i++) {
+            float best = std::max(std::max(src[i], std::max(src[i - 1], src[i + 1])),
+                                  std::max(src[i - rowStep], src[i + rowStep]));
+            dst[i] = std::max(best * decay * walk[i], fixed[i]);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef INFLUENCEMAP_H
+#define INFLUENCEMAP_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "entity.h"
+
+class Maze;
+
+/**
+ * Float fields over the maze grid that frightened ghosts steer by:
+ *
+ *   danger - 1 on Pac-Man's tile and fading along his heading, spread
+ *            through the corridors by DANGER_DECAY per tile
+ *   home   - HOME_DECAY per tile of distance from the ghost spawn
+ *            tiles, built once by a breadth-first search
+ *
+ * Fields are stored with a one-tile border and rows padded to 8 floats,
+ * so a diffusion pass is a straight loop along each row (AVX2 with
+ * PACMAN_ENABLE_AVX2, otherwise plain code the compiler can vectorise).
+ * Tunnel rows/columns copy their far edge into the border before each
+ * pass, so the fields wrap like the maze does.
+ *
+ * DANGER_PASSES passes carry danger at most that many tiles past the
+ * lookahead, so they only run over the window around Pac-Man that it
+ * can reach. The cost is a fixed number of small passes per Pac-Man
+ * move, however large the maze and however many ghosts sample it.
+ */
+class InfluenceMap {
+public:
+    static constexpr int DANGER_PASSES = 16;
+    static constexpr float DANGER_DECAY = 0.8f;
+    static constexpr int LOOKAHEAD = 4;               // tiles of heading that count as danger
+    static constexpr float LOOKAHEAD_FALLOFF = 0.9f;  // per tile ahead
+    static constexpr float HOME_DECAY = 0.95f;
+    static constexpr float HOME_WEIGHT = 0.3f;
+
+    InfluenceMap();
+
+    // Take the maze layout and build the home field. Call again after
+    // the walkable layout changes.
+    void build(const Maze& maze, const glm::ivec2* home_tiles, int home_count);
+    bool isBuilt() const { return width > 0; }
+
+    // Danger field for Pac-Man's tile and heading; cheap if neither changed
+    void update(const Maze& maze, glm::ivec2 pacman_pos, Direction heading);
+
+    // Lower is safer: danger minus the pull toward home
+    float sample(int x, int y) const {
+        size_t i = index(x, y);
+        return danger[i] - HOME_WEIGHT * home[i];
+    }
+    float getDanger(int x, int y) const { return danger[index(x, y)]; }
+    float getHome(int x, int y) const { return home[index(x, y)]; }
+
+private:
+    int width;
+    int height;
+    int stride;
+    std::vector<float> mask;      // 1 on walkable tiles
+    std::vector<float> home;
+    std::vector<float> danger;
+    std::vector<float> seeds;
+    std::vector<float> scratch;
+    std::vector<uint32_t> seeded;
+    std::vector<uint32_t> wrapCopies;   // (border index, source index) pairs
+    bool rowsWrap;                      // some row/column has a tunnel
+    bool columnsWrap;
+    glm::ivec2 lastPos;
+    Direction lastHeading;
+
+    // Tiles [x0, x1) x [y0, y1) that the last danger update wrote
+    struct Window {
+        int x0, y0, x1, y1;
+    };
+    Window window;
+
+    size_t index(int x, int y) const { return static_cast<size_t>(y + 1) * stride + x + 1; }
+
+    // Zero the tiles of the window in both danger buffers
+    void clearWindow();
+
+    // One pass over the window's tiles:
+    // out = max(seed, mask * decay * max(in and its 4 neighbours))
+    void diffuse(std::vector<float>& in, std::vector<float>& out, const std::vector<float>& seed, float decay,
+                 const Window& area) const;
+};
+
+#endif // INFLUENCEMAP_H
@@ -0,0 +1,251 @@
+#include "junctiongraph.h"
+#include "maze.h"
+#include <algorithm>
+
+namespace {
+    const Direction ALL_DIRECTIONS[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+    uint8_t directionBit(Direction dir) {
+        return static_cast<uint8_t>(1u << static_cast<int>(dir));
+    }
+
+    // Single set bit of a 4-bit mask as a direction, NONE otherwise
+    Direction soleDirection(uint8_t mask) {
+        switch (mask) {
+            case 1: return Direction::UP;
+            case 2: return Direction::DOWN;
+            case 4: return Direction::LEFT;
+            case 8: return Direction::RIGHT;
+            default: return Direction::NONE;
+        }
+    }
+
+    int exitCount(uint8_t mask) {
+        return (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+    }
+}
+
+JunctionGraph::JunctionGraph() : width(0), height(0), walkableCount(0) {}
+
+void JunctionGraph::build(const Maze& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    exitMasks.assign(width * height, 0);
+    nodeIndex.assign(width * height, -1);
+    nodes.clear();
+    edges.clear();
+
+    // Exits per tile; anything not a plain two-exit corridor becomes a node
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t mask = computeExitMask(maze, x, y);
+            exitMasks[y * width + x] = mask;
+
+            if (maze.isWalkable(x, y) && exitCount(mask) != 2) {
+                nodeIndex[y * width + x] = static_cast<int>(nodes.size());
+                nodes.push_back({glm::ivec2(x, y), {-1, -1, -1, -1}});
+            }
+        }
+    }
+
+    for (size_t n = 0; n < nodes.size(); n++) walkEdges(maze, static_cast<int>(n));
+
+    walkableCount = 0;
+    for (uint8_t mask : exitMasks) {
+        if (mask) walkableCount++;
+    }
+}
+
+void JunctionGraph::updateTile(const Maze& maze, int x, int y) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+
+    // The tile's own exits and its neighbours' exits into it change
+    glm::ivec2 changed[5];
+    int count = 0;
+    changed[count++] = glm::ivec2(x, y);
+    for (Direction dir : ALL_DIRECTIONS) {
+        glm::ivec2 offset = Entity::getDirectionOffset(dir);
+        glm::ivec2 tile((x + offset.x + width) % width, (y + offset.y + height) % height);
+        if (std::find(changed, changed + count, tile) == changed + count) changed[count++] = tile;
+    }
+
+    // Nodes whose corridors run through the changed tiles, found on the
+    // old graph. A changed node may stop being one, so the nodes across
+    // its corridors are redone too.
+    std::vector<glm::ivec2> redo;
+    auto addRedo = [&](int node) {
+        if (node >= 0 && std::find(redo.begin(), redo.end(), nodes[node].tile) == redo.end()) {
+            redo.push_back(nodes[node].tile);
+        }
+    };
+    for (int i = 0; i < count; i++) {
+        const glm::ivec2& tile = changed[i];
+        int node = nodeIndex[tile.y * width + tile.x];
+        if (node >= 0) {
+            addRedo(node);
+            for (int e : nodes[node].edges) {
+                if (e >= 0) addRedo(edges[e].to);
+            }
+            continue;
+        }
+        for (Direction dir : ALL_DIRECTIONS) {
+            if (exitMasks[tile.y * width + tile.x] & directionBit(dir)) addRedo(findCorridorEnd(tile.x, tile.y, dir));
+        }
+    }
+
+    // Their edges go; removing from the back keeps the indices still to
+    // be removed in place
+    std::vector<int> stale;
+    for (const glm::ivec2& tile : redo) {
+        for (int e : nodes[nodeIndex[tile.y * width + tile.x]].edges) {
+            if (e >= 0) stale.push_back(e);
+        }
+    }
+    std::sort(stale.begin(), stale.end(), std::greater<int>());
+    for (int e : stale) removeEdge(e);
+
+    // New exits, and nodes appearing or disappearing with them
+    for (int i = 0; i < count; i++) {
+        const glm::ivec2& tile = changed[i];
+        uint8_t& mask = exitMasks[tile.y * width + tile.x];
+        walkableCount -= mask ? 1 : 0;
+        mask = computeExitMask(maze, tile.x, tile.y);
+        walkableCount += mask ? 1 : 0;
+
+        bool wasNode = nodeIndex[tile.y * width + tile.x] >= 0;
+        if (maze.isWalkable(tile.x, tile.y) && exitCount(mask) != 2 && !wasNode) {
+            nodeIndex[tile.y * width + tile.x] = static_cast<int>(nodes.size());
+            nodes.push_back({tile, {-1, -1, -1, -1}});
+            redo.push_back(tile);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        const glm::ivec2& tile = changed[i];
+        int node = nodeIndex[tile.y * width + tile.x];
+        if (node >= 0 && !(maze.isWalkable(tile.x, tile.y) && exitCount(exitMasks[tile.y * width + tile.x]) != 2)) {
+            removeNode(node);
+        }
+    }
+
+    for (const glm::ivec2& tile : redo) {
+        int node = nodeIndex[tile.y * width + tile.x];
+        if (node >= 0) walkEdges(maze, node);
+    }
+}
+
+uint8_t JunctionGraph::computeExitMask(const Maze& maze, int x, int y) const {
+    if (!maze.isWalkable(x, y)) return 0;
+
+    uint8_t mask = 0;
+    for (Direction dir : ALL_DIRECTIONS) {
+        if (maze.getNeighbour(x, y, dir) != Maze::NO_NEIGHBOUR) {
+            mask |= directionBit(dir);
+        }
+    }
+    return mask;
+}
+
+void JunctionGraph::walkEdges(const Maze& maze, int n) {
+    glm::ivec2 start = nodes[n].tile;
+    uint8_t startMask = exitMasks[start.y * width + start.x];
+
+    for (Direction dir : ALL_DIRECTIONS) {
+        if (!(startMask & directionBit(dir))) continue;
+
+        JunctionEdge edge;
+        edge.from = n;
+        edge.to = -1;
+        edge.startDir = dir;
+        edge.length = 0;
+
+        glm::ivec2 pos = start;
+        Direction heading = dir;
+        while (heading != Direction::NONE && edge.length <= width * height) {
+            uint32_t next = maze.getNeighbour(pos.x, pos.y, heading);
+            pos = glm::ivec2(static_cast<int>(next % width), static_cast<int>(next / width));
+            edge.length++;
+
+            int node = nodeIndex[pos.y * width + pos.x];
+            if (node >= 0) {
+                edge.to = node;
+                break;
+            }
+            edge.tiles.push_back(pos);
+            heading = continueCorridor(pos.x, pos.y, heading);
+        }
+
+        if (edge.to < 0) continue;
+        nodes[n].edges[static_cast<int>(dir)] = static_cast<int>(edges.size());
+        edges.push_back(std::move(edge));
+    }
+}
+
+int JunctionGraph::findCorridorEnd(int x, int y, Direction dir) const {
+    // Exits only ever lead to walkable tiles, wrapping at open edges the
+    // way the maze links do
+    glm::ivec2 pos(x, y);
+    Direction heading = dir;
+    for (int steps = 0; heading != Direction::NONE && steps <= width * height; steps++) {
+        glm::ivec2 offset = Entity::getDirectionOffset(heading);
+        pos = glm::ivec2((pos.x + offset.x + width) % width, (pos.y + offset.y + height) % height);
+        int node = nodeIndex[pos.y * width + pos.x];
+        if (node >= 0) return node;
+        heading = continueCorridor(pos.x, pos.y, heading);
+    }
+    return -1;
+}
+
+void JunctionGraph::removeEdge(int e) {
+    const JunctionEdge& edge = edges[e];
+    nodes[edge.from].edges[static_cast<int>(edge.startDir)] = -1;
+
+    int last = static_cast<int>(edges.size()) - 1;
+    if (e != last) {
+        edges[e] = std::move(edges[last]);
+        nodes[edges[e].from].edges[static_cast<int>(edges[e].startDir)] = e;
+    }
+    edges.pop_back();
+}
+
+void JunctionGraph::removeNode(int n) {
+    // Only called once its corridors are gone, so nothing points at it
+    const glm::ivec2 tile = nodes[n].tile;
+    nodeIndex[tile.y * width + tile.x] = -1;
+
+    int last = static_cast<int>(nodes.size()) - 1;
+    if (n != last) {
+        nodes[n] = nodes[last];
+        const glm::ivec2& moved = nodes[n].tile;
+        nodeIndex[moved.y * width + moved.x] = n;
+
+        for (int e : nodes[n].edges) {
+            if (e >= 0) edges[e].from = n;
+        }
+        // Corridors into the moved node, found from its side
+        for (Direction dir : ALL_DIRECTIONS) {
+            if (!(exitMasks[moved.y * width + moved.x] & directionBit(dir))) continue;
+            int far = findCorridorEnd(moved.x, moved.y, dir);
+            if (far < 0) continue;
+            for (int e : nodes[far].edges) {
+                if (e >= 0 && edges[e].to == last) edges[e].to = n;
+            }
+        }
+    }
+    nodes.pop_back();
+}
+
+int JunctionGraph::getNodeIndex(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) return -1;
+    return nodeIndex[y * width + x];
+}
+
+uint8_t JunctionGraph::getExitMask(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) return 0;
+    return exitMasks[y * width + x];
+}
+
+Direction JunctionGraph::continueCorridor(int x, int y, Direction heading) const {
+    if (heading == Direction::NONE || isNode(x, y)) return Direction::NONE;
+    uint8_t mask = getExitMask(x, y) & ~directionBit(Entity::getOppositeDirection(heading));
+    return soleDirection(mask);
+}
@@ -0,0 +1,86 @@
+#ifndef JUNCTIONGRAPH_H
+#define JUNCTIONGRAPH_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "entity.h"
+
+class Maze;
+
+/**
+ * Intersection or dead end: any walkable tile without exactly two exits.
+ */
+struct JunctionNode {
+    glm::ivec2 tile;
+    int edges[4];       // Outgoing edge per Direction, -1 if blocked
+};
+
+/**
+ * Directed corridor between two nodes. Tiles lists the corridor
+ * interior in travel order (empty for adjacent nodes).
+ */
+struct JunctionEdge {
+    int from;
+    int to;
+    Direction startDir;     // Direction leaving the from node
+    int length;             // Steps from node to node
+    std::vector<glm::ivec2> tiles;
+};
+
+/**
+ * Compressed view of a maze: junctions as nodes, corridors as weighted
+ * edges. Entities only need to decide at nodes; between them the single
+ * onward exit is the only legal move.
+ */
+class JunctionGraph {
+public:
+    JunctionGraph();
+
+    // Rebuild from the maze's walkable layout
+    void build(const Maze& maze);
+
+    // Tile (x, y) changed walkability: redo the exits around it and the
+    // nodes and corridors that pass through them. The maze links must
+    // already be up to date.
+    void updateTile(const Maze& maze, int x, int y);
+
+    // Node index of a tile (-1 for corridor or non-walkable tiles)
+    int getNodeIndex(int x, int y) const;
+    bool isNode(int x, int y) const { return getNodeIndex(x, y) >= 0; }
+
+    // Bitmask of walkable exits, bit (1 << Direction)
+    uint8_t getExitMask(int x, int y) const;
+
+    // Onward direction inside a corridor (NONE at nodes or if blocked)
+    Direction continueCorridor(int x, int y, Direction heading) const;
+
+    const std::vector<JunctionNode>& getNodes() const { return nodes; }
+    const std::vector<JunctionEdge>& getEdges() const { return edges; }
+
+    // Tiles with at least one walkable exit
+    int getWalkableCount() const { return walkableCount; }
+
+private:
+    int width;
+    int height;
+    int walkableCount;
+    std::vector<uint8_t> exitMasks;
+    std::vector<int> nodeIndex;
+    std::vector<JunctionNode> nodes;
+    std::vector<JunctionEdge> edges;
+
+    uint8_t computeExitMask(const Maze& maze, int x, int y) const;
+
+    // Walk every exit of node n to the next node and add the edges
+    void walkEdges(const Maze& maze, int n);
+
+    // Node at the far end of the corridor leaving (x, y) toward dir,
+    // following exitMasks; -1 if it never reaches one
+    int findCorridorEnd(int x, int y, Direction dir) const;
+
+    void removeEdge(int e);
+    void removeNode(int n);
+};
+
+#endif // JUNCTIONGRAPH_H
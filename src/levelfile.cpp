@@ -0,0 +1,387 @@
+#include "levelfile.h"
+#include "maze.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    struct LevelHeader {
+        uint32_t magic;
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        int32_t pacmanSpawn[2];
+        int32_t ghostSpawns[LevelInfo::GHOST_COUNT][2];
+        int32_t houseMin[2];
+        int32_t houseMax[2];
+        uint32_t pelletCount;   // pellets and power pellets, as a sanity check
+        uint32_t tileChecksum;  // tileChecksum() of the tile bytes
+    };
+    static_assert(sizeof(LevelHeader) == 80, "level header layout is part of the file format");
+
+    // 32-bit FNV-1a
+    uint32_t tileChecksum(const uint8_t* bytes, size_t count) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < count; i++) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Anything mapping to zero bytes still counts as open
+    const uint8_t EMPTY_FILE = 0;
+
+    bool inBounds(const Maze& maze, glm::ivec2 tile) {
+        return tile.x >= 0 && tile.x < maze.getWidth() && tile.y >= 0 && tile.y < maze.getHeight();
+    }
+
+    // Tiles reachable from a walkable start
+    std::vector<uint8_t> reach(const Maze& maze, glm::ivec2 start, bool through_doors) {
+        const int width = maze.getWidth();
+        std::vector<uint8_t> seen(static_cast<size_t>(width) * maze.getHeight(), 0);
+        std::vector<uint32_t> queue;
+        auto visit = [&](uint32_t tile) {
+            if (seen[tile]) return;
+            if (!through_doors && maze.getTile(tile % width, tile / width) == TileType::DOOR) return;
+            seen[tile] = 1;
+            queue.push_back(tile);
+        };
+
+        visit(static_cast<uint32_t>(start.y * width + start.x));
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (int d = 0; d < 4; d++) {
+                uint32_t next = maze.getNeighbour(queue[head], static_cast<Direction>(d));
+                if (next != Maze::NO_NEIGHBOUR) visit(next);
+            }
+        }
+        return seen;
+    }
+
+    // Maze wraps at every open edge, so a tunnel is any row or column
+    // walkable at both ends
+    void findTunnels(const Maze& maze, std::vector<TunnelLink>& tunnels) {
+        const int width = maze.getWidth();
+        const int height = maze.getHeight();
+        tunnels.clear();
+        for (int y = 0; y < height && width > 1; y++) {
+            if (maze.isWalkable(0, y) && maze.isWalkable(width - 1, y)) {
+                tunnels.push_back(TunnelLink{glm::ivec2(0, y), glm::ivec2(width - 1, y)});
+            }
+        }
+        for (int x = 0; x < width && height > 1; x++) {
+            if (maze.isWalkable(x, 0) && maze.isWalkable(x, height - 1)) {
+                tunnels.push_back(TunnelLink{glm::ivec2(x, 0), glm::ivec2(x, height - 1)});
+            }
+        }
+    }
+
+    bool standable(const Maze& maze, glm::ivec2 tile) {
+        return inBounds(maze, tile) && maze.isWalkable(tile.x, tile.y);
+    }
+
+    std::string tileName(glm::ivec2 tile) {
+        return "(" + std::to_string(tile.x) + ", " + std::to_string(tile.y) + ")";
+    }
+}
+
+MappedFile::MappedFile()
+    : data(nullptr)
+    , size(0)
+#ifdef _WIN32
+    , file(nullptr)
+    , mapping(nullptr)
+#endif
+{}
+
+MappedFile::MappedFile(const std::string& path) : MappedFile() {
+    open(path);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(handle, &length)) {
+        CloseHandle(handle);
+        return false;
+    }
+    file = handle;
+    size = static_cast<size_t>(length.QuadPart);
+    if (size == 0) {
+        data = &EMPTY_FILE;
+        return true;
+    }
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        size = static_cast<size_t>(info.st_size);
+        if (size == 0) {
+            data = &EMPTY_FILE;
+        } else {
+            void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) data = static_cast<const uint8_t*>(view);
+        }
+    }
+    ::close(fd);    // the mapping keeps the file alive
+#endif
+    if (!data) close();
+    return data != nullptr;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data && data != &EMPTY_FILE) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (file) CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data && data != &EMPTY_FILE) munmap(const_cast<uint8_t*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+bool LevelFile::isBinary(const uint8_t* data, size_t size) {
+    uint32_t magic = 0;
+    if (size < sizeof(magic)) return false;
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == MAGIC;
+}
+
+bool LevelFile::read(const uint8_t* data, size_t size, Maze& maze, const std::string& path) {
+    LevelHeader header{};
+    if (size < sizeof(header)) {
+        std::cerr << "ERROR::LEVEL: " << path << " is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != VERSION) {
+        std::cerr << "ERROR::LEVEL: " << path << " is version " << header.version
+                  << ", expected " << VERSION << " (convert it again)" << std::endl;
+        return false;
+    }
+    if (header.width <= 0 || header.width > MAX_SIDE || header.height <= 0 || header.height > MAX_SIDE) {
+        std::cerr << "ERROR::LEVEL: " << path << " has a bad size" << std::endl;
+        return false;
+    }
+
+    const size_t tileCount = static_cast<size_t>(header.width) * header.height;
+    if (size != sizeof(header) + tileCount) {
+        std::cerr << "ERROR::LEVEL: " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    // Tile bytes are TileType values already; one copy and a range check
+    const uint8_t* tileBytes = data + sizeof(header);
+    if (tileChecksum(tileBytes, tileCount) != header.tileChecksum) {
+        std::cerr << "ERROR::LEVEL: " << path << " is corrupt (tile checksum mismatch)" << std::endl;
+        return false;
+    }
+    std::vector<TileType> tiles(tileCount);
+    std::memcpy(tiles.data(), tileBytes, tileCount);
+    for (size_t i = 0; i < tileCount; i++) {
+        if (tileBytes[i] > static_cast<uint8_t>(TileType::DOOR)) {
+            std::cerr << "ERROR::LEVEL: " << path << " has an unknown tile" << std::endl;
+            return false;
+        }
+    }
+
+    LevelInfo info;
+    info.pacmanSpawn = glm::ivec2(header.pacmanSpawn[0], header.pacmanSpawn[1]);
+    for (int i = 0; i < LevelInfo::GHOST_COUNT; i++) {
+        info.ghostSpawns[i] = glm::ivec2(header.ghostSpawns[i][0], header.ghostSpawns[i][1]);
+    }
+    info.houseMin = glm::ivec2(header.houseMin[0], header.houseMin[1]);
+    info.houseMax = glm::ivec2(header.houseMax[0], header.houseMax[1]);
+
+    maze.setLayout(header.width, header.height, std::move(tiles));
+    findTunnels(maze, info.tunnels);
+    maze.setInfo(info);
+
+    // validate() ran at conversion; only catch files changed since
+    std::vector<std::string> problems = checkSpawns(maze, info);
+    for (const std::string& problem : problems) {
+        std::cerr << "ERROR::LEVEL: " << path << ": " << problem << std::endl;
+    }
+    if (!problems.empty() || maze.getRemainingPellets() != static_cast<int>(header.pelletCount)) {
+        std::cerr << "ERROR::LEVEL: " << path << " is corrupt" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LevelFile::write(const Maze& maze, const std::string& path) {
+    const LevelInfo& info = maze.getInfo();
+    LevelHeader header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.width = maze.getWidth();
+    header.height = maze.getHeight();
+    header.pacmanSpawn[0] = info.pacmanSpawn.x;
+    header.pacmanSpawn[1] = info.pacmanSpawn.y;
+    for (int i = 0; i < LevelInfo::GHOST_COUNT; i++) {
+        header.ghostSpawns[i][0] = info.ghostSpawns[i].x;
+        header.ghostSpawns[i][1] = info.ghostSpawns[i].y;
+    }
+    header.houseMin[0] = info.houseMin.x;
+    header.houseMin[1] = info.houseMin.y;
+    header.houseMax[0] = info.houseMax.x;
+    header.houseMax[1] = info.houseMax.y;
+    header.pelletCount = static_cast<uint32_t>(maze.getRemainingPellets());
+
+    std::vector<uint8_t> tiles(static_cast<size_t>(header.width) * header.height);
+    for (int y = 0; y < header.height; y++) {
+        for (int x = 0; x < header.width; x++) {
+            tiles[y * header.width + x] = static_cast<uint8_t>(maze.getTile(x, y));
+        }
+    }
+    header.tileChecksum = tileChecksum(tiles.data(), tiles.size());
+
+    // Write to a temporary file first so a crash never leaves a torn level
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "ERROR::LEVEL: Could not write " << tmpPath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(tiles.data()), tiles.size());
+        if (!file) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void LevelFile::describe(const Maze& maze, LevelInfo& info) {
+    const int width = maze.getWidth();
+    const int height = maze.getHeight();
+    findTunnels(maze, info.tunnels);
+
+    // The house is whatever Pac-Man can only get to through a door
+    info.houseMin = glm::ivec2(-1, -1);
+    info.houseMax = glm::ivec2(-1, -1);
+    if (!inBounds(maze, info.pacmanSpawn) || !maze.isWalkable(info.pacmanSpawn.x, info.pacmanSpawn.y)) return;
+    std::vector<uint8_t> outside = reach(maze, info.pacmanSpawn, false);
+    std::vector<uint8_t> all = reach(maze, info.pacmanSpawn, true);
+    glm::ivec2 low(width, height);
+    glm::ivec2 high(-1, -1);
+    for (size_t i = 0; i < all.size(); i++) {
+        if (!all[i] || outside[i]) continue;
+        int x = static_cast<int>(i % width);
+        int y = static_cast<int>(i / width);
+        low = glm::ivec2(std::min(low.x, x), std::min(low.y, y));
+        high = glm::ivec2(std::max(high.x, x), std::max(high.y, y));
+    }
+    if (high.x >= 0) {
+        info.houseMin = low;
+        info.houseMax = high;
+    }
+}
+
+std::vector<std::string> LevelFile::checkSpawns(const Maze& maze, const LevelInfo& info) {
+    std::vector<std::string> problems;
+    auto check = [&](glm::ivec2 spawn, const std::string& name, const char* marker) {
+        if (!inBounds(maze, spawn)) problems.push_back(name + " " + tileName(spawn) + " is off the map (" + marker + ")");
+        else if (!maze.isWalkable(spawn.x, spawn.y)) problems.push_back(name + " " + tileName(spawn) + " is inside a wall");
+    };
+    check(info.pacmanSpawn, "Pac-Man spawn", "mark one with 'P'");
+    for (int i = 0; i < LevelInfo::GHOST_COUNT; i++) {
+        check(info.ghostSpawns[i], "ghost " + std::to_string(i) + " spawn", "mark four with 'G'");
+    }
+    return problems;
+}
+
+std::vector<std::string> LevelFile::validate(const Maze& maze) {
+    std::vector<std::string> problems;
+    const int width = maze.getWidth();
+    const int height = maze.getHeight();
+    if (width <= 0 || width > MAX_SIDE || height <= 0 || height > MAX_SIDE) {
+        problems.push_back("size " + std::to_string(width) + "x" + std::to_string(height) +
+                           " is outside 1.." + std::to_string(MAX_SIDE));
+        return problems;
+    }
+
+    const LevelInfo& info = maze.getInfo();
+    problems = checkSpawns(maze, info);
+    if (!standable(maze, info.pacmanSpawn)) return problems;
+
+    std::vector<uint8_t> reachable = reach(maze, info.pacmanSpawn, true);
+    for (int i = 0; i < LevelInfo::GHOST_COUNT; i++) {
+        glm::ivec2 spawn = info.ghostSpawns[i];
+        if (standable(maze, spawn) && !reachable[spawn.y * width + spawn.x]) {
+            problems.push_back("ghost " + std::to_string(i) + " spawn " + tileName(spawn) + " can't reach Pac-Man");
+        }
+    }
+
+    int pellets = 0;
+    int stranded = 0;
+    glm::ivec2 firstStranded(-1, -1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            TileType tile = maze.getTile(x, y);
+            if (tile != TileType::PELLET && tile != TileType::POWER) continue;
+            pellets++;
+            if (reachable[y * width + x]) continue;
+            if (stranded++ == 0) firstStranded = glm::ivec2(x, y);
+        }
+    }
+    if (pellets == 0) problems.push_back("there are no pellets");
+    if (stranded > 0) {
+        problems.push_back(std::to_string(stranded) + " pellets can't be reached from Pac-Man's spawn, first at " +
+                           tileName(firstStranded));
+    }
+    return problems;
+}
+
+bool LevelFile::convert(const std::string& in_path, const std::string& out_path) {
+    Maze maze;
+    if (!maze.load(in_path)) return false;
+
+    std::vector<std::string> problems = validate(maze);
+    for (const std::string& problem : problems) {
+        std::cerr << "ERROR::LEVEL: " << in_path << ": " << problem << std::endl;
+    }
+    if (!problems.empty()) return false;
+
+    if (!write(maze, out_path)) {
+        std::cerr << "ERROR::LEVEL: Could not write " << out_path << std::endl;
+        return false;
+    }
+    std::cout << "Converted " << in_path << " -> " << out_path << " (" << maze.getWidth() << "x"
+              << maze.getHeight() << ", " << maze.getRemainingPellets() << " pellets, "
+              << maze.getInfo().tunnels.size() << " tunnels)" << std::endl;
+    return true;
+}
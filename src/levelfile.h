@@ -0,0 +1,80 @@
+#ifndef LEVELFILE_H
+#define LEVELFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Maze;
+struct LevelInfo;
+
+/**
+ * Read-only memory mapping of a whole file (empty if it can't be opened).
+ */
+class MappedFile {
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const uint8_t* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#endif
+};
+
+/**
+ * Binary level format (.pmlv).
+ *
+ * A fixed header (size, spawns, ghost house bounds, pellet count and an
+ * FNV-1a checksum of the tiles), then one byte per tile in Maze's row
+ * order. Tunnels aren't stored: Maze wraps at every open edge, so they
+ * are worked out from the tiles on load.
+ * Maze::load maps the file and copies the tile bytes straight into its
+ * storage, so loading costs one memcpy plus the layout rebuild however
+ * large the level is. Files are only written by convert(), after the
+ * level has passed validate().
+ */
+namespace LevelFile {
+    constexpr uint32_t MAGIC = 0x564C4D50;  // "PMLV"
+    constexpr uint32_t VERSION = 3;
+    constexpr int MAX_SIDE = 4096;
+
+    // True if the mapped bytes start with a binary level header
+    bool isBinary(const uint8_t* data, size_t size);
+
+    // Fill maze and its info from mapped .pmlv bytes; false on a bad file
+    bool read(const uint8_t* data, size_t size, Maze& maze, const std::string& path);
+
+    // Write maze and its info as a .pmlv file (through a temporary file)
+    bool write(const Maze& maze, const std::string& path);
+
+    // Ghost house bounds and tunnel links, derived from the layout
+    void describe(const Maze& maze, LevelInfo& info);
+
+    // Spawns off the map or inside a wall; every load runs this
+    std::vector<std::string> checkSpawns(const Maze& maze, const LevelInfo& info);
+
+    // Problems that make a level unplayable: bad spawns (as above), pellets
+    // Pac-Man can't reach, no pellets at all. Empty if fine.
+    std::vector<std::string> validate(const Maze& maze);
+
+    // Load a level (text or binary), validate it and write it as binary
+    bool convert(const std::string& in_path, const std::string& out_path);
+}
+
+#endif // LEVELFILE_H
@@ -0,0 +1,95 @@
+#include "levelmanager.h"
+#include "pathtable.h"
+#include "replay.h"
+#include <chrono>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+LevelManager::LevelManager(std::vector<std::string> level_paths)
+    : paths(std::move(level_paths))
+    , current(0)
+{}
+
+LevelManager::~LevelManager() {
+    if (next.valid()) next.wait();
+}
+
+std::unique_ptr<PreparedLevel> LevelManager::start() {
+    if (paths.empty()) return nullptr;
+    current = 0;
+    std::unique_ptr<PreparedLevel> level = prepare(paths[current]);
+    if (level) preloadNext();
+    return level;
+}
+
+std::unique_ptr<PreparedLevel> LevelManager::takeNext() {
+    if (ready) return std::move(ready);
+    if (!next.valid()) return nullptr;
+
+    // Normally finished long ago; a wait here is the hitch preloading hides
+    auto begin = std::chrono::steady_clock::now();
+    std::unique_ptr<PreparedLevel> level = next.get();
+    double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    if (waitMs >= 1.0) {
+        std::cout << "Level preload wasn't ready, waited " << waitMs << " ms" << std::endl;
+    }
+
+    // A level that failed to load stays next in line
+    if (!level) preloadNext();
+    return level;
+}
+
+void LevelManager::advance() {
+    current = (current + 1) % paths.size();
+    preloadNext();
+}
+
+void LevelManager::putBack(std::unique_ptr<PreparedLevel> level) {
+    ready = std::move(level);
+}
+
+bool LevelManager::isNextReady() const {
+    return ready || (next.valid() && next.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+void LevelManager::preloadNext() {
+    next = std::async(std::launch::async, &LevelManager::prepare, paths[(current + 1) % paths.size()]);
+}
+
+std::unique_ptr<PreparedLevel> LevelManager::prepare(const std::string& path) {
+    auto level = std::make_unique<PreparedLevel>();
+    level->path = path;
+    if (!level->maze.load(path)) return nullptr;
+    level->maze.setPathTable(PathTable::loadOrBuild(level->maze, path + ".paths"));
+
+    // The GL thread only reads tiles and rewrites pellets on its copy
+    level->view = level->maze;
+    level->view.setPathTable(nullptr);
+    buildGeometry(level->view, level->walls, level->floors);
+    level->hash = ReplayLog::hashLevel(path);
+    return level;
+}
+
+void LevelManager::buildGeometry(const Maze& maze, std::vector<glm::mat4>& walls, std::vector<glm::mat4>& floors) {
+    walls.clear();
+    floors.clear();
+    for (int y = 0; y < maze.getHeight(); ++y) {
+        for (int x = 0; x < maze.getWidth(); ++x) {
+            glm::vec3 worldPos = maze.gridToWorld(x, y);
+            switch (maze.getTile(x, y)) {
+                case TileType::WALL:
+                    walls.push_back(glm::translate(glm::mat4(1.0f), worldPos + glm::vec3(0.0f, 0.5f, 0.0f)));
+                    break;
+                case TileType::FLOOR:
+                case TileType::PELLET:
+                case TileType::POWER:
+                case TileType::DOOR:
+                    floors.push_back(glm::translate(glm::mat4(1.0f), worldPos));
+                    break;
+                case TileType::EMPTY:
+                default:
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef LEVELMANAGER_H
+#define LEVELMANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "maze.h"
+
+/**
+ * Everything a level needs before it can be played, built off the main
+ * thread: the simulation's maze with its path table, a render-side copy,
+ * and the instance transforms of its static geometry.
+ */
+struct PreparedLevel {
+    std::string path;
+    Maze maze;                          // for Simulation::init(Maze&&, path)
+    Maze view;                          // for the GL thread's pellet refresh
+    std::vector<glm::mat4> walls;
+    std::vector<glm::mat4> floors;
+    uint64_t hash = 0;                  // ReplayLog::hashLevel of the file
+};
+
+/**
+ * Plays a list of level files in order, looping. While one level is
+ * played the next is prepared on a background thread, so moving on is a
+ * swap of ready-made data rather than a load.
+ */
+class LevelManager {
+public:
+    explicit LevelManager(std::vector<std::string> level_paths);
+    ~LevelManager();
+
+    LevelManager(const LevelManager&) = delete;
+    LevelManager& operator=(const LevelManager&) = delete;
+
+    // Prepare the first level on this thread and start on the second.
+    // nullptr if the first level doesn't load.
+    std::unique_ptr<PreparedLevel> start();
+
+    // The next level, waiting for its preload if it hasn't finished.
+    // Follow with advance() once it is handed off, or putBack() if the
+    // hand-off failed. nullptr if it failed to load; it is retried.
+    std::unique_ptr<PreparedLevel> takeNext();
+
+    // The taken level is being played: move on and prepare the one after
+    void advance();
+
+    // Keep a taken level for the next takeNext()
+    void putBack(std::unique_ptr<PreparedLevel> level);
+
+    bool isNextReady() const;
+    size_t getCurrentIndex() const { return current; }
+    size_t getLevelCount() const { return paths.size(); }
+    const std::string& getCurrentPath() const { return paths[current]; }
+
+    // Load, path table and geometry for one level (runs on any thread)
+    static std::unique_ptr<PreparedLevel> prepare(const std::string& path);
+
+    // Wall and floor instance transforms for a maze, as MazeRenderer draws them
+    static void buildGeometry(const Maze& maze, std::vector<glm::mat4>& walls, std::vector<glm::mat4>& floors);
+
+private:
+    std::vector<std::string> paths;
+    size_t current;
+    std::future<std::unique_ptr<PreparedLevel>> next;
+    std::unique_ptr<PreparedLevel> ready;   // put back after a failed hand-off
+
+    void preloadNext();
+};
+
+#endif // LEVELMANAGER_H
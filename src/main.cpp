@@ -5,6 +5,8 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <string>
+#include <cstdlib>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -14,15 +16,21 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "shader.h"
+#include "shadervariants.h"
+#include "shadercache.h"
 #include "mesh.h"
 #include "camera.h"
 #include "maze.h"
 #include "renderer.h"
+#include "levelmanager.h"
+#include "chunkworld.h"
 #include "pacman.h"
-#include "ghost.h"
+#include "simthread.h"
 #include "audio.h"
 #include "model.h"
 #include "ui.h"
+#include "framepacer.h"
+#include "scenetarget.h"
 
 constexpr int WINDOW_WIDTH = 1280;
 constexpr int WINDOW_HEIGHT = 720;
@@ -34,14 +42,21 @@ constexpr float SKY_B = 230.0f / 255.0f;
 float g_camera_angle = 45.0f;
 float g_camera_distance = 25.0f;
 float g_camera_height = 20.0f;
-Direction g_input_dir = Direction::NONE;
 
 AudioManager* g_audio = nullptr;
 UIManager* g_ui = nullptr;
+SimulationThread* g_sim = nullptr;
+FramePacer* g_pacer = nullptr;
+SceneTarget* g_sceneTarget = nullptr;
 double g_mouseX = 0, g_mouseY = 0;
 
-bool checkCollision(const PacMan& pacman, const Ghost& ghost) {
-    return (pacman.grid_x == ghost.grid_x && pacman.grid_y == ghost.grid_y);
+// Endless mode has no simulation thread; its runner reads input directly
+bool g_endless = false;
+Direction g_endlessInput = Direction::NONE;
+
+void sendInput(Direction dir) {
+    if (g_endless) g_endlessInput = dir;
+    else if (g_sim) g_sim->send(SimCommandType::INPUT, dir);
 }
 
 float directionToAngle(Direction dir, bool reverse = false) {
@@ -56,16 +71,6 @@ float directionToAngle(Direction dir, bool reverse = false) {
     return reverse ? base + 180.0f : base;
 }
 
-glm::vec3 getGhostTint(GhostType type) {
-    switch (type) {
-        case GhostType::BLINKY: return glm::vec3(1.0f, 0.2f, 0.2f);
-        case GhostType::PINKY:  return glm::vec3(1.0f, 0.6f, 0.8f);
-        case GhostType::INKY:   return glm::vec3(0.2f, 0.8f, 1.0f);
-        case GhostType::CLYDE:  return glm::vec3(1.0f, 0.6f, 0.2f);
-        default: return glm::vec3(1.0f);
-    }
-}
-
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (action == GLFW_PRESS || action == GLFW_REPEAT) {
         // Handle UI navigation with Enter/Escape
@@ -81,21 +86,30 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
         }
         
         switch (key) {
-            case GLFW_KEY_W: case GLFW_KEY_UP:    g_input_dir = Direction::UP; break;
-            case GLFW_KEY_S: case GLFW_KEY_DOWN:  g_input_dir = Direction::DOWN; break;
-            case GLFW_KEY_A: case GLFW_KEY_LEFT:  g_input_dir = Direction::RIGHT; break;
-            case GLFW_KEY_D: case GLFW_KEY_RIGHT: g_input_dir = Direction::LEFT; break;
+            case GLFW_KEY_W: case GLFW_KEY_UP:    sendInput(Direction::UP); break;
+            case GLFW_KEY_S: case GLFW_KEY_DOWN:  sendInput(Direction::DOWN); break;
+            case GLFW_KEY_A: case GLFW_KEY_LEFT:  sendInput(Direction::RIGHT); break;
+            case GLFW_KEY_D: case GLFW_KEY_RIGHT: sendInput(Direction::LEFT); break;
             case GLFW_KEY_Q: g_camera_angle -= 5.0f; break;
             case GLFW_KEY_E: g_camera_angle += 5.0f; break;
             case GLFW_KEY_R: g_camera_distance = std::max(10.0f, g_camera_distance - 2.0f); break;
             case GLFW_KEY_F: g_camera_distance = std::min(50.0f, g_camera_distance + 2.0f); break;
             case GLFW_KEY_M: if (g_audio) g_audio->stopMusic(); break;
+            case GLFW_KEY_V: if (g_pacer) g_pacer->cycleMode(); break;
+            case GLFW_KEY_B: if (g_sim) g_sim->send(SimCommandType::TOGGLE_AUTOPLAY); break;
+            case GLFW_KEY_LEFT_BRACKET:
+                if (g_sim && g_sim->isReplaying()) g_sim->setReplaySpeed(std::max(0.125f, g_sim->getReplaySpeed() * 0.5f));
+                break;
+            case GLFW_KEY_RIGHT_BRACKET:
+                if (g_sim && g_sim->isReplaying()) g_sim->setReplaySpeed(std::min(64.0f, g_sim->getReplaySpeed() * 2.0f));
+                break;
             case GLFW_KEY_P: 
                 if (g_ui && g_ui->getState() == GameState::PLAYING) g_ui->showPauseMenu();
                 else if (g_ui && g_ui->getState() == GameState::PAUSED) g_ui->hide();
                 break;
             case GLFW_KEY_ESCAPE: 
-                if (g_ui && g_ui->getState() == GameState::PLAYING) g_ui->showPauseMenu();
+                if (g_endless) glfwSetWindowShouldClose(window, GLFW_TRUE);
+                else if (g_ui && g_ui->getState() == GameState::PLAYING) g_ui->showPauseMenu();
                 else if (g_ui && g_ui->getState() == GameState::MAIN_MENU) glfwSetWindowShouldClose(window, GLFW_TRUE);
                 break;
         }
@@ -121,9 +135,98 @@ void cursorPosCallback(GLFWwindow* window, double x, double y) {
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
     if (g_ui) g_ui->setScreenSize(width, height);
+    if (g_sceneTarget) g_sceneTarget->resize(width, height);
+}
+
+/**
+ * Endless mode (--world [seed]): Pac-Man runs through a streamed
+ * ChunkWorld until the window closes. Chunks are generated and meshed in
+ * the background around him and uploaded as they finish.
+ */
+void runEndless(GLFWwindow* window, ShaderVariants& shaders, FramePacer& pacer, uint64_t seed,
+                Model& pacmanModel, bool usePacmanModel) {
+    ChunkWorld world(seed);
+    WorldRunner runner;
+    const glm::ivec2 start(1, 1);
+    world.prefetch(start);
+    runner.reset(start);
+    
+    ChunkRenderer chunkRenderer;
+    chunkRenderer.loadTextures();
+    chunkRenderer.setFog(glm::vec3(SKY_R, SKY_G, SKY_B));
+    shaders.prewarm({
+        SHADER_INSTANCED | SHADER_VERTEX_COLOR | SHADER_FOG,
+        SHADER_INSTANCED | SHADER_TEXTURED | SHADER_FOG });
+    Mesh pacmanCube = createCube(PacMan::COLOR);
+    
+    Camera camera;
+    camera.setPerspective(45.0f, static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT, 0.1f, 200.0f);
+    Shader& shader = *shaders.get(SHADER_VERTEX_COLOR);
+    
+    g_endless = true;
+    std::cout << "\nEndless mode, seed " << seed << " - Escape quits" << std::endl;
+    
+    int swapInterval = pacer.getSwapInterval();
+    double prev_time = glfwGetTime();
+    float eatAnimTime = 0.0f;
+    while (!glfwWindowShouldClose(window)) {
+        double current_time = glfwGetTime();
+        float dt = std::min(static_cast<float>(current_time - prev_time), 0.1f);
+        prev_time = current_time;
+        
+        runner.step(world, dt, g_endlessInput);
+        g_endlessInput = Direction::NONE;
+        world.update(runner.getTile());
+        chunkRenderer.sync(world);
+        if (runner.isMoving()) eatAnimTime += dt * 8.0f;
+        
+        glm::vec3 pos = runner.getWorldPos();
+        camera.setupThirdPerson(pos, 0.0f, 10.0f, 8.0f);
+        
+        glClearColor(SKY_R, SKY_G, SKY_B, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        
+        chunkRenderer.render(shaders, camera);
+        
+        glm::mat4 view = camera.getViewMatrix();
+        glm::mat4 proj = camera.getProjectionMatrix();
+        shader.use();
+        shader.setVec3("colorTint", glm::vec3(1.0f));
+        shader.setMat4("view", view);
+        shader.setMat4("projection", proj);
+        
+        glm::mat4 modelMat = glm::translate(glm::mat4(1.0f), pos);
+        if (usePacmanModel) {
+            modelMat = glm::rotate(modelMat, glm::radians(directionToAngle(runner.getDirection())), glm::vec3(0, 1, 0));
+            float eatScale = runner.isMoving() ? 0.5f + 0.05f * std::sin(eatAnimTime) : 0.5f;
+            modelMat = glm::scale(modelMat, glm::vec3(eatScale));
+            pacmanModel.render(shader, modelMat, view, proj);
+        } else {
+            modelMat = glm::scale(modelMat, glm::vec3(0.8f));
+            shader.setMat4("model", modelMat);
+            pacmanCube.draw();
+        }
+        
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        
+        if (pacer.getSwapInterval() != swapInterval) {
+            swapInterval = pacer.getSwapInterval();
+            glfwSwapInterval(swapInterval);
+        }
+        pacer.setBackground(!glfwGetWindowAttrib(window, GLFW_FOCUSED) ||
+                            glfwGetWindowAttrib(window, GLFW_ICONIFIED));
+        pacer.endFrame();
+        pacer.report();
+    }
+    
+    g_endless = false;
+    const ChunkWorld::Stats& stats = world.getStats();
+    std::cout << "Endless: " << runner.getTilesTravelled() << " tiles, score " << runner.getScore()
+              << ", " << stats.generated << " chunks generated, " << stats.evicted << " evicted" << std::endl;
 }
 
-int main() {
+int main(int argc, char** argv) {
     glfwSetErrorCallback([](int e, const char* d) { std::cerr << "GLFW " << e << ": " << d << "\n"; });
     if (!glfwInit()) return -1;
     
@@ -139,7 +242,11 @@ int main() {
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetCursorPosCallback(window, cursorPosCallback);
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
-    glfwSwapInterval(0); // Disable vsync for max FPS
+    
+    FramePacer pacer;
+    g_pacer = &pacer;
+    int swapInterval = pacer.getSwapInterval();
+    glfwSwapInterval(swapInterval);
     
     if (!gladLoadGL()) { glfwDestroyWindow(window); glfwTerminate(); return -1; }
     
@@ -154,35 +261,85 @@ int main() {
         audio.playMusic("assets/audio/music.wav");
     }
     
-    Shader shader;
-    if (!shader.load("shaders/vertex.glsl", "shaders/fragment.glsl")) return -1;
+    // Reuse linked program binaries from previous runs when the driver allows
+    ShaderCache shaderCache("shader_cache");
+    if (shaderCache.init()) {
+        Shader::setCache(&shaderCache);
+    }
+    
+    // Feature-specialised permutations of the main program
+    ShaderVariants shaders("shaders/vertex.glsl", "shaders/fragment.glsl");
+    const uint32_t SCENE_FEATURES = SHADER_VERTEX_COLOR;
+    const uint32_t UI_FEATURES = 0;
+    if (!shaders.prewarm({
+            SCENE_FEATURES,
+            UI_FEATURES,
+            SHADER_INSTANCED | SHADER_VERTEX_COLOR,
+            SHADER_INSTANCED | SHADER_TEXTURED })) return -1;
+    Shader& shader = *shaders.get(SCENE_FEATURES);
+    Shader& uiShader = *shaders.get(UI_FEATURES);
+    if (shaderCache.isEnabled()) {
+        std::cout << "Shader cache: " << shaderCache.getHits() << " hits, "
+                  << shaderCache.getMisses() << " misses" << std::endl;
+    }
     
     Model pacmanModel, ghostModel, treeModel;
     bool usePacmanModel = pacmanModel.load("assets/sprites/PacmanFinal.glb");
     bool useGhostModel = ghostModel.load("assets/sprites/Ghosts.glb");
     bool useTreeModel = treeModel.load("assets/sprites/voxel trees 3d model.glb");
     
-    Maze maze;
-    if (!maze.load("levels/level1.txt")) return -1;
+    // --world [seed]: endless streamed maze instead of the level
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) != "--world") continue;
+        uint64_t seed = (i + 1 < argc && argv[i + 1][0] != '-') ? std::strtoull(argv[i + 1], nullptr, 10) : 1;
+        runEndless(window, shaders, pacer, seed, pacmanModel, usePacmanModel);
+        g_pacer = nullptr;
+        Shader::setCache(nullptr);
+        audio.shutdown();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return 0;
+    }
+    
+    // --level <path> (repeatable): text or binary (.pmlv) levels to play
+    // in order instead of level1. Each next one preloads in the background.
+    std::vector<std::string> levelPaths;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--level") levelPaths.push_back(argv[i + 1]);
+    }
+    if (levelPaths.empty()) levelPaths.push_back("levels/level1.txt");
+    LevelManager levels(levelPaths);
+    std::unique_ptr<PreparedLevel> firstLevel = levels.start();
+    if (!firstLevel) return -1;
+    
+    // Render-side copy of the level; pellets are refreshed from snapshots
+    Maze maze = std::move(firstLevel->view);
     
     MazeRenderer mazeRenderer;
     mazeRenderer.loadTextures();
-    mazeRenderer.buildFromMaze(maze);
-    
-    PacMan pacman;
-    pacman.createMesh();
-    pacman.setGridPosition(14, 6, maze);
-    
-    std::vector<Ghost> ghosts;
-    ghosts.emplace_back(GhostType::BLINKY);
-    ghosts.emplace_back(GhostType::PINKY);
-    ghosts.emplace_back(GhostType::INKY);
-    ghosts.emplace_back(GhostType::CLYDE);
-    
-    int ghost_spawns[][2] = {{1, 23}, {26, 23}, {1, 1}, {26, 1}};
-    for (int i = 0; i < 4; i++) {
-        ghosts[i].createMesh();
-        ghosts[i].respawn(maze, ghost_spawns[i][0], ghost_spawns[i][1]);
+    mazeRenderer.buildFromGeometry(maze, firstLevel->walls, firstLevel->floors);
+    
+    // Game simulation runs on its own thread
+    SimulationThread sim;
+    if (!sim.init(std::move(firstLevel))) return -1;
+    g_sim = &sim;
+    
+    // --replay <file>: watch a recorded game instead of playing
+    // --autoplay: let the search bot play (B toggles it in game)
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc && !sim.startReplay(argv[i + 1])) return -1;
+        if (arg == "--autoplay") sim.send(SimCommandType::TOGGLE_AUTOPLAY);
+    }
+    
+    // Fallback cubes when the glTF models are missing
+    Mesh pacmanCube = createCube(PacMan::COLOR);
+    Mesh ghostCube = createCube(glm::vec3(1.0f));
+    
+    // 3D scene renders offscreen at a GPU-time driven resolution scale
+    SceneTarget sceneTarget;
+    if (sceneTarget.init(WINDOW_WIDTH, WINDOW_HEIGHT)) {
+        g_sceneTarget = &sceneTarget;
     }
     
     Camera camera;
@@ -210,21 +367,29 @@ int main() {
     // Voxel grass - larger cubes for better FPS
     Mesh grassMesh = createCube(glm::vec3(0.35f, 0.65f, 0.25f)); // Green grass cube
     Mesh dirtMesh = createCube(glm::vec3(0.55f, 0.4f, 0.25f)); // Brown dirt
-    std::vector<glm::vec3> grassPositions;
+    std::vector<glm::mat4> grassTransforms;
+    std::vector<glm::mat4> dirtTransforms;
     // Create grass grid - larger step for performance
+    int grassIdx = 0;
     for (float x = mazeCenter.x - 45; x < mazeCenter.x + 45; x += 2.0f) {
         for (float z = mazeCenter.z - 45; z < mazeCenter.z + 45; z += 2.0f) {
-            grassPositions.push_back(glm::vec3(x, -0.5f, z));
+            glm::mat4 grassMat = glm::translate(glm::mat4(1.0f), glm::vec3(x, -0.5f, z));
+            grassMat = glm::scale(grassMat, glm::vec3(1.9f, 0.4f, 1.9f)); // Bigger to fill gaps
+            // Alternate grass and dirt for variety
+            if ((grassIdx++ % 7) == 0) {
+                dirtTransforms.push_back(grassMat);
+            } else {
+                grassTransforms.push_back(grassMat);
+            }
         }
     }
+    grassMesh.setInstances(grassTransforms);
+    dirtMesh.setInstances(dirtTransforms);
     
     double prev_time = glfwGetTime();
-    bool gameOver = false;
-    bool gameOverPrinted = false;
-    float deathTimer = 0.0f;
-    int ghostEatBonus = 200;
-    int lastScore = 0;
     float eatAnimTime = 0.0f;
+    unsigned int pelletVersion = 0;
+    unsigned int levelSerial = 0;   // levels handed to the simulation
     
     // Initialize UI
     UIManager ui;
@@ -235,15 +400,7 @@ int main() {
     // UI Callbacks
     ui.onStartGame = [&]() {
         ui.hide();
-        gameOver = false;
-        gameOverPrinted = false;
-        pacman.lives = 3;
-        pacman.score = 0;
-        maze.load("levels/level1.txt");
-        mazeRenderer.buildFromMaze(maze);
-        pacman.respawn(maze);
-        for (int i = 0; i < 4; i++)
-            ghosts[i].respawn(maze, ghost_spawns[i][0], ghost_spawns[i][1]);
+        sim.send(SimCommandType::NEW_GAME);
         audio.playMusic("assets/audio/music.wav");
     };
     
@@ -253,15 +410,37 @@ int main() {
     
     ui.onRestartGame = [&]() {
         ui.hide();
-        gameOver = false;
-        gameOverPrinted = false;
-        pacman.lives = 3;
-        pacman.score = 0;
-        maze.load("levels/level1.txt");
-        mazeRenderer.buildFromMaze(maze);
-        pacman.respawn(maze);
-        for (int i = 0; i < 4; i++)
-            ghosts[i].respawn(maze, ghost_spawns[i][0], ghost_spawns[i][1]);
+        sim.send(SimCommandType::NEW_GAME);
+        audio.playMusic("assets/audio/music.wav");
+    };
+    
+    // Swap in the preloaded next level; GL and simulation sides move
+    // together, and snapshots from the old level are ignored meanwhile
+    ui.onNextLevel = [&]() {
+        ui.hide();
+        std::unique_ptr<PreparedLevel> next = sim.isReplaying() ? nullptr : levels.takeNext();
+        if (next) {
+            // Once queued the level belongs to the simulation, so keep the
+            // GL side's parts first and only switch to them if it was sent
+            Maze view = std::move(next->view);
+            std::vector<glm::mat4> walls = std::move(next->walls);
+            std::vector<glm::mat4> floors = std::move(next->floors);
+            if (sim.sendLevel(next)) {
+                levels.advance();
+                maze = std::move(view);
+                mazeRenderer.buildFromGeometry(maze, walls, floors);
+                levelSerial++;
+            } else {
+                // Replay this level and offer the same one next time
+                next->view = std::move(view);
+                next->walls = std::move(walls);
+                next->floors = std::move(floors);
+                levels.putBack(std::move(next));
+                sim.send(SimCommandType::NEW_GAME);
+            }
+        } else {
+            sim.send(SimCommandType::NEW_GAME);
+        }
         audio.playMusic("assets/audio/music.wav");
     };
     
@@ -274,110 +453,85 @@ int main() {
     audio.stopMusic(); // Don't play music in menu
     
     std::cout << "\nVoxel Pac-Man 3D - Press START to play!" << std::endl;
+    bool simRunning = false;
+    sim.start();
     while (!glfwWindowShouldClose(window)) {
         double current_time = glfwGetTime();
         float dt = static_cast<float>(current_time - prev_time);
         prev_time = current_time;
         
-        // Skip game logic when UI is showing (not playing)
-        if (ui.getState() != GameState::PLAYING) {
-            // Just render UI
-            goto render_frame;
+        // Simulation only ticks while the game is on screen
+        bool playing = ui.getState() == GameState::PLAYING;
+        if (playing != simRunning) {
+            sim.send(playing ? SimCommandType::RESUME : SimCommandType::PAUSE);
+            simRunning = playing;
         }
         
-        // Eating animation timer
-        eatAnimTime += dt * 8.0f;
-        
-        if (!gameOver && !pacman.isDead) {
-            if (g_input_dir != Direction::NONE) {
-                pacman.handleInput(g_input_dir, maze);
-                g_input_dir = Direction::NONE;
-            }
-            pacman.continueMovement(maze);
-            pacman.update(dt);
-            
-            if (pacman.collectPellet(maze)) {
-                ghostEatBonus = 200;
-                for (auto& ghost : ghosts) ghost.setFrightened(8.0f);
-            }
-            
-            if (pacman.score != lastScore) {
-                audio.playSound("assets/audio/eat.mp3");
-                lastScore = pacman.score;
-                std::cout << "Score: " << pacman.score << std::endl;
-            }
-            
-            glm::ivec2 ppos(pacman.grid_x, pacman.grid_y);
-            for (auto& ghost : ghosts) {
-                ghost.updateAI(maze, ppos);
-                ghost.update(dt);
-                
-                if (!ghost.isEaten && checkCollision(pacman, ghost)) {
-                    if (ghost.mode == GhostMode::FRIGHTENED) {
-                        ghost.isEaten = true;
-                        pacman.score += ghostEatBonus;
-                        std::cout << "Ate ghost! +" << ghostEatBonus << std::endl;
-                        ghostEatBonus *= 2;
-                    } else {
-                        pacman.die();
-                        audio.playSound("assets/audio/death.wav");
-                        deathTimer = 1.5f;
-                    }
-                }
+        // React to what happened on the simulation thread
+        SimEvent event;
+        while (sim.pollEvent(event)) {
+            switch (event.type) {
+                case SimEventType::SCORE_CHANGED:
+                    audio.playSound("assets/audio/eat.mp3");
+                    break;
+                case SimEventType::PACMAN_DIED:
+                    audio.playSound("assets/audio/death.wav");
+                    break;
+                case SimEventType::GAME_OVER:
+                    audio.stopMusic();
+                    ui.showGameOver(event.score);
+                    break;
+                case SimEventType::LEVEL_CLEARED:
+                    audio.stopMusic();
+                    ui.showWin(event.score);
+                    break;
             }
         }
-        else if (pacman.isDead) {
-            deathTimer -= dt;
-            if (deathTimer <= 0.0f) {
-                if (pacman.lives <= 0) {
-                    gameOver = true;
-                    audio.stopMusic();
-                    if (!gameOverPrinted) {
-                        std::cout << "\n=== GAME OVER === Score: " << pacman.score << std::endl;
-                        gameOverPrinted = true;
-                        ui.showGameOver(pacman.score);
-                    }
-                } else {
-                    pacman.respawn(maze);
-                    for (int i = 0; i < 4; i++)
-                        ghosts[i].respawn(maze, ghost_spawns[i][0], ghost_spawns[i][1]);
-                    std::cout << "Lives: " << pacman.lives << std::endl;
+        
+        const RenderSnapshot& snap = sim.acquireSnapshot();
+        bool levelInSync = snap.level == levelSerial;
+        if (levelInSync && snap.pelletVersion != pelletVersion) {
+            for (int y = 0; y < maze.getHeight(); ++y) {
+                for (int x = 0; x < maze.getWidth(); ++x) {
+                    int index = y * maze.getWidth() + x;
+                    TileType tile = maze.getTile(x, y);
+                    if (snap.hasPellet(index)) maze.setTile(x, y, TileType::PELLET);
+                    else if (snap.hasPower(index)) maze.setTile(x, y, TileType::POWER);
+                    else if (tile == TileType::PELLET || tile == TileType::POWER) maze.setTile(x, y, TileType::FLOOR);
                 }
             }
+            pelletVersion = snap.pelletVersion;
         }
         
-        render_frame:
+        // Eating animation timer
+        if (playing) eatAnimTime += dt * 8.0f;
+        
         // Fixed third person camera following Pac-Man (doesn't rotate)
-        camera.setupThirdPerson(pacman.world_pos, 0.0f, 10.0f, 8.0f);
+        camera.setupThirdPerson(snap.pacman.world_pos, 0.0f, 10.0f, 8.0f);
         
+        sceneTarget.begin();
         glClearColor(SKY_R, SKY_G, SKY_B, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
-        shader.use();
-        shader.setVec3("colorTint", glm::vec3(1.0f));
-        shader.setBool("useTexture", false);
-        mazeRenderer.render(shader, camera);
-        mazeRenderer.renderPellets(shader, maze);
+        mazeRenderer.render(shaders, camera);
+        mazeRenderer.renderPellets(shaders, camera, maze);
         
         glm::mat4 view = camera.getViewMatrix();
         glm::mat4 proj = camera.getProjectionMatrix();
         
-        // Render voxel grass around maze
+        // Render voxel grass around maze (one instanced draw per mesh)
+        Shader& instancedShader = *shaders.get(SHADER_INSTANCED | SHADER_VERTEX_COLOR);
+        instancedShader.use();
+        instancedShader.setVec3("colorTint", glm::vec3(1.0f));
+        instancedShader.setMat4("view", view);
+        instancedShader.setMat4("projection", proj);
+        grassMesh.drawInstanced();
+        dirtMesh.drawInstanced();
+        
+        shader.use();
         shader.setVec3("colorTint", glm::vec3(1.0f));
         shader.setMat4("view", view);
         shader.setMat4("projection", proj);
-        int grassIdx = 0;
-        for (const auto& pos : grassPositions) {
-            glm::mat4 grassMat = glm::translate(glm::mat4(1.0f), pos);
-            grassMat = glm::scale(grassMat, glm::vec3(1.9f, 0.4f, 1.9f)); // Bigger to fill gaps
-            shader.setMat4("model", grassMat);
-            // Alternate grass and dirt for variety
-            if ((grassIdx++ % 7) == 0) {
-                dirtMesh.draw();
-            } else {
-                grassMesh.draw();
-            }
-        }
         
         // Render trees with green/brown tint
         if (useTreeModel) {
@@ -403,20 +557,19 @@ int main() {
             cloudMesh.draw();
         }
         
-        if (!gameOver) {
+        if (!snap.gameOver && levelInSync) {
             // Render Pac-Man with eating animation
-            if (!pacman.isDead) {
-                shader.setVec3("colorTint", glm::vec3(1.0f, 1.0f, 0.2f));
+            if (snap.pacman.visible) {
+                shader.setVec3("colorTint", snap.pacman.tint);
+                glm::mat4 modelMat = glm::translate(glm::mat4(1.0f), snap.pacman.world_pos);
                 if (usePacmanModel) {
-                    glm::mat4 modelMat = glm::translate(glm::mat4(1.0f), pacman.world_pos);
-                    
                     // Rotation facing forward
-                    float angle = directionToAngle(pacman.current_dir);
+                    float angle = directionToAngle(snap.pacman.dir);
                     modelMat = glm::rotate(modelMat, glm::radians(angle), glm::vec3(0, 1, 0));
                     
                     // Eating animation: scale pulsing
                     float eatScale = 0.5f;
-                    if (pacman.is_moving) {
+                    if (snap.pacman.is_moving) {
                         float pulse = 0.05f * std::sin(eatAnimTime);
                         eatScale = 0.5f + pulse;
                     }
@@ -424,40 +577,56 @@ int main() {
                     
                     pacmanModel.render(shader, modelMat, view, proj);
                 } else {
-                    pacman.render(shader);
+                    modelMat = glm::scale(modelMat, glm::vec3(0.8f));
+                    shader.setMat4("model", modelMat);
+                    pacmanCube.draw();
                 }
             }
             
             // Render ghosts
-            for (auto& ghost : ghosts) {
-                if (!ghost.isEaten) {
-                    glm::vec3 tint = (ghost.mode == GhostMode::FRIGHTENED) 
-                        ? glm::vec3(0.2f, 0.2f, 1.0f)
-                        : getGhostTint(ghost.ghost_type);
-                    shader.setVec3("colorTint", tint);
-                    
-                    if (useGhostModel) {
-                        glm::mat4 modelMat = glm::translate(glm::mat4(1.0f), ghost.world_pos);
-                        float angle = directionToAngle(ghost.current_dir) + 180.0f;
-                        modelMat = glm::rotate(modelMat, glm::radians(angle), glm::vec3(0, 1, 0));
-                        modelMat = glm::scale(modelMat, glm::vec3(0.3f));
-                        ghostModel.render(shader, modelMat, view, proj);
-                    } else {
-                        ghost.render(shader);
-                    }
+            for (const auto& ghost : snap.ghosts) {
+                if (!ghost.visible) continue;
+                shader.setVec3("colorTint", ghost.tint);
+                
+                glm::mat4 modelMat = glm::translate(glm::mat4(1.0f), ghost.world_pos);
+                if (useGhostModel) {
+                    float angle = directionToAngle(ghost.dir) + 180.0f;
+                    modelMat = glm::rotate(modelMat, glm::radians(angle), glm::vec3(0, 1, 0));
+                    modelMat = glm::scale(modelMat, glm::vec3(0.3f));
+                    ghostModel.render(shader, modelMat, view, proj);
+                } else {
+                    modelMat = glm::scale(modelMat, glm::vec3(0.8f));
+                    shader.setMat4("model", modelMat);
+                    ghostCube.draw();
                 }
             }
             
             shader.setVec3("colorTint", glm::vec3(1.0f));
         }
         
-        // Render UI overlay
-        ui.render(shader);
+        // Upscale the scene, then draw UI at native resolution
+        sceneTarget.end();
+        ui.render(uiShader);
         
         glfwSwapBuffers(window);
         glfwPollEvents();
+        
+        // Throttle menus and hidden/unfocused windows, then wait for the next frame slot
+        if (pacer.getSwapInterval() != swapInterval) {
+            swapInterval = pacer.getSwapInterval();
+            glfwSwapInterval(swapInterval);
+        }
+        pacer.setIdle(ui.getState() != GameState::PLAYING);
+        pacer.setBackground(!glfwGetWindowAttrib(window, GLFW_FOCUSED) ||
+                            glfwGetWindowAttrib(window, GLFW_ICONIFIED));
+        pacer.endFrame();
+        pacer.report();
     }
     
+    sim.stop();
+    g_sim = nullptr;
+    g_sceneTarget = nullptr;
+    Shader::setCache(nullptr);
     audio.shutdown();
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -1,25 +1,48 @@
 #include "maze.h"
-#include <fstream>
+#include "levelfile.h"
+#include "pacman.h"
 #include <iostream>
 #include <algorithm>
 
-Maze::Maze() : width(0), height(0) {}
+LevelInfo::LevelInfo()
+    : pacmanSpawn(PacMan::SPAWN_X, PacMan::SPAWN_Y)
+    , ghostSpawns{{1, 23}, {26, 23}, {1, 1}, {26, 1}}
+    , houseMin(-1, -1)
+    , houseMax(-1, -1)
+{}
+
+Maze::Maze() : width(0), height(0), fieldTarget(-1, -1) {}
 
 bool Maze::load(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    MappedFile file(filepath);
+    if (!file.isOpen()) {
         std::cerr << "ERROR::MAZE: Could not open file: " << filepath << std::endl;
         return false;
     }
     
-    // Read all lines to determine dimensions
-    std::vector<std::string> lines;
-    std::string line;
+    if (LevelFile::isBinary(file.getData(), file.getSize())) {
+        if (!LevelFile::read(file.getData(), file.getSize(), *this, filepath)) return false;
+    } else {
+        if (!parseText(reinterpret_cast<const char*>(file.getData()), file.getSize())) return false;
+    }
     
-    while (std::getline(file, line)) {
-        if (!line.empty()) {
-            lines.push_back(line);
-        }
+    std::cout << "Loaded maze: " << width << "x" << height << " tiles" << std::endl;
+    std::cout << "Junction graph: " << junctionGraph.getNodes().size() << " nodes, "
+              << junctionGraph.getEdges().size() << " edges ("
+              << junctionGraph.getWalkableCount() << " walkable tiles)" << std::endl;
+    return true;
+}
+
+bool Maze::parseText(const char* text, size_t size) {
+    // Non-empty lines, top of the file first
+    std::vector<std::pair<const char*, size_t>> lines;
+    size_t lineStart = 0;
+    for (size_t i = 0; i <= size; ++i) {
+        if (i < size && text[i] != '\n') continue;
+        size_t length = i - lineStart;
+        if (length > 0 && text[lineStart + length - 1] == '\r') length--;
+        if (length > 0) lines.emplace_back(text + lineStart, length);
+        lineStart = i + 1;
     }
     
     if (lines.empty()) {
@@ -28,25 +51,46 @@ bool Maze::load(const std::string& filepath) {
     }
     
     // Determine maze dimensions
-    height = static_cast<int>(lines.size());
-    width = 0;
+    int newHeight = static_cast<int>(lines.size());
+    int newWidth = 0;
     for (const auto& l : lines) {
-        width = std::max(width, static_cast<int>(l.length()));
+        newWidth = std::max(newWidth, static_cast<int>(l.second));
     }
     
-    // Allocate tile array
-    tiles.resize(width * height, TileType::EMPTY);
-    
     // Parse tiles (flip Y so bottom of file is Y=0)
-    for (int y = 0; y < height; ++y) {
-        const std::string& row = lines[height - 1 - y];
-        for (int x = 0; x < static_cast<int>(row.length()); ++x) {
-            tiles[y * width + x] = charToTile(row[x]);
+    std::vector<TileType> newTiles(static_cast<size_t>(newWidth) * newHeight, TileType::EMPTY);
+    LevelInfo newInfo;
+    int ghostMarks = 0;
+    for (int y = 0; y < newHeight; ++y) {
+        const auto& row = lines[newHeight - 1 - y];
+        for (int x = 0; x < static_cast<int>(row.second); ++x) {
+            char c = row.first[x];
+            newTiles[y * newWidth + x] = charToTile(c);
+            if (c == 'P') newInfo.pacmanSpawn = glm::ivec2(x, y);
+            if (c == 'G' && ghostMarks < LevelInfo::GHOST_COUNT) newInfo.ghostSpawns[ghostMarks++] = glm::ivec2(x, y);
         }
     }
     
-    std::cout << "Loaded maze: " << width << "x" << height << " tiles" << std::endl;
-    return true;
+    setLayout(newWidth, newHeight, std::move(newTiles));
+    LevelFile::describe(*this, newInfo);
+    info = newInfo;
+    
+    std::vector<std::string> problems = LevelFile::checkSpawns(*this, info);
+    for (const std::string& problem : problems) {
+        std::cerr << "ERROR::MAZE: " << problem << std::endl;
+    }
+    return problems.empty();
+}
+
+void Maze::setLayout(int new_width, int new_height, std::vector<TileType> new_tiles) {
+    width = new_width;
+    height = new_height;
+    tiles = std::move(new_tiles);
+    tiles.resize(static_cast<size_t>(width) * height, TileType::EMPTY);
+    info = LevelInfo();
+    fieldTarget = glm::ivec2(-1, -1);
+    pathTable.reset();
+    rebuildLayout();
 }
 
 TileType Maze::getTile(int x, int y) const {
@@ -58,7 +102,19 @@ TileType Maze::getTile(int x, int y) const {
 
 void Maze::setTile(int x, int y, TileType type) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
+        bool wasWalkable = isWalkable(x, y);
         tiles[y * width + x] = type;
+        bits.setTile(x, y, type == TileType::FLOOR || type == TileType::PELLET ||
+                           type == TileType::POWER || type == TileType::DOOR,
+                     type == TileType::PELLET, type == TileType::POWER);
+        // Eating pellets keeps the layout; anything else invalidates paths
+        if (isWalkable(x, y) != wasWalkable) {
+            fieldTarget = glm::ivec2(-1, -1);
+            pathTable.reset();
+            relinkTile(x, y);
+            junctionGraph.updateTile(*this, x, y);
+            hierarchy.updateTile(*this, x, y);
+        }
     }
 }
 
@@ -79,6 +135,8 @@ glm::ivec2 Maze::worldToGrid(const glm::vec3& pos) const {
 }
 
 bool Maze::isWalkable(int x, int y) const {
+    if (bits.isValid()) return bits.isWalkable(x, y);
+    
     TileType tile = getTile(x, y);
     return tile == TileType::FLOOR || 
            tile == TileType::PELLET || 
@@ -86,10 +144,119 @@ bool Maze::isWalkable(int x, int y) const {
            tile == TileType::DOOR;
 }
 
+void Maze::rebuildLayout() {
+    // Walkable queries below read the bitboards, so build them first
+    bits.build(*this);
+    
+    links.assign(width * height, TileLinks{{NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR}});
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (!isWalkable(x, y)) continue;
+            for (int d = 0; d < 4; ++d) {
+                glm::ivec2 offset = Entity::getDirectionOffset(static_cast<Direction>(d));
+                // Stepping off an open edge comes back in on the opposite one
+                int nx = (x + offset.x + width) % width;
+                int ny = (y + offset.y + height) % height;
+                if (isWalkable(nx, ny)) {
+                    links[y * width + x].next[d] = static_cast<uint32_t>(ny * width + nx);
+                }
+            }
+        }
+    }
+    
+    junctionGraph.build(*this);
+    
+    if (width * height >= HIERARCHY_MIN_TILES) {
+        hierarchy.build(*this);
+    } else {
+        hierarchy.clear();
+    }
+}
+
+void Maze::relinkTile(int x, int y) {
+    // Links run between walkable tiles only, both ways
+    uint32_t index = static_cast<uint32_t>(y * width + x);
+    bool walkable = isWalkable(x, y);
+    for (int d = 0; d < 4; ++d) {
+        glm::ivec2 offset = Entity::getDirectionOffset(static_cast<Direction>(d));
+        int nx = (x + offset.x + width) % width;
+        int ny = (y + offset.y + height) % height;
+        uint32_t next = static_cast<uint32_t>(ny * width + nx);
+        bool open = walkable && isWalkable(nx, ny);
+        int back = static_cast<int>(Entity::getOppositeDirection(static_cast<Direction>(d)));
+        links[index].next[d] = open ? next : NO_NEIGHBOUR;
+        if (isWalkable(nx, ny)) links[next].next[back] = walkable ? index : NO_NEIGHBOUR;
+    }
+}
+
+int Maze::getRemainingPellets() const {
+    if (bits.isValid()) return bits.countPellets() + bits.countPowers();
+    
+    int count = 0;
+    for (TileType tile : tiles) {
+        if (tile == TileType::PELLET || tile == TileType::POWER) count++;
+    }
+    return count;
+}
+
+bool Maze::isCleared() const {
+    if (bits.isValid()) return bits.isCleared();
+    return getRemainingPellets() == 0;
+}
+
 glm::vec3 Maze::getCenter() const {
     return glm::vec3(0.0f, 0.0f, 0.0f);
 }
 
+void Maze::updateDistanceField(int target_x, int target_y) {
+    if (fieldTarget == glm::ivec2(target_x, target_y)) return;
+    
+    fieldTarget = glm::ivec2(target_x, target_y);
+    fieldDistance.assign(width * height, -1);
+    fieldDirection.assign(width * height, Direction::NONE);
+    if (!isWalkable(target_x, target_y)) return;
+    
+    // Breadth-first search outward from the target. A tile discovered from
+    // a neighbour steps back toward that neighbour to follow the path.
+    static const Direction order[] = {Direction::UP, Direction::LEFT, Direction::DOWN, Direction::RIGHT};
+    std::vector<int> queue;
+    queue.reserve(width * height);
+    
+    int start = target_y * width + target_x;
+    fieldDistance[start] = 0;
+    queue.push_back(start);
+    
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int index = queue[head];
+        
+        for (Direction dir : order) {
+            uint32_t link = links[index].next[static_cast<int>(dir)];
+            if (link == NO_NEIGHBOUR) continue;
+            
+            int next = static_cast<int>(link);
+            if (fieldDistance[next] != -1) continue;
+            
+            fieldDistance[next] = fieldDistance[index] + 1;
+            fieldDirection[next] = Entity::getOppositeDirection(dir);
+            queue.push_back(next);
+        }
+    }
+}
+
+int Maze::getFieldDistance(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height || fieldDistance.empty()) {
+        return -1;
+    }
+    return fieldDistance[y * width + x];
+}
+
+Direction Maze::getFieldDirection(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height || fieldDirection.empty()) {
+        return Direction::NONE;
+    }
+    return fieldDirection[y * width + x];
+}
+
 TileType Maze::charToTile(char c) const {
     switch (c) {
         case '#': return TileType::WALL;
@@ -1,14 +1,22 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
+#include "entity.h"
+#include "junctiongraph.h"
+#include "mazebits.h"
+#include "pathhierarchy.h"
+
+class PathTable;
 
 /**
  * Tile types for the maze grid.
  */
-enum class TileType {
+enum class TileType : uint8_t {
     EMPTY,      // Empty space (outside maze, tunnels)
     WALL,       // Solid wall block
     FLOOR,      // Walkable floor
@@ -17,6 +25,31 @@ enum class TileType {
     DOOR        // Ghost house door
 };
 
+// Tile pair joined across opposite open edges (a wrapping tunnel)
+struct TunnelLink {
+    glm::ivec2 a;
+    glm::ivec2 b;
+};
+
+/**
+ * Where a level's actors start, plus layout facts worked out once on load.
+ * Text levels may mark spawns with 'P' (Pac-Man) and 'G' (ghosts, in
+ * Blinky, Pinky, Inky, Clyde order); unmarked ones keep the classic 28x25
+ * tiles. Binary levels store the spawns and house; tunnels always come
+ * from the tiles, since Maze wraps at every open edge.
+ */
+struct LevelInfo {
+    static constexpr int GHOST_COUNT = 4;
+    
+    glm::ivec2 pacmanSpawn;
+    glm::ivec2 ghostSpawns[GHOST_COUNT];
+    glm::ivec2 houseMin;    // ghost house bounds with its doors,
+    glm::ivec2 houseMax;    // (-1, -1) for both if there is none
+    std::vector<TunnelLink> tunnels;
+    
+    LevelInfo();
+};
+
 /**
  * Maze class for loading and managing the game grid.
  * Converts 2D grid coordinates to 3D world positions.
@@ -25,9 +58,18 @@ class Maze {
 public:
     Maze();
     
-    // Load maze from text file
+    // Load a text level, or a binary one written by LevelFile::convert
     bool load(const std::string& filepath);
     
+    // Take a layout built in memory (row-major, y = 0 at the bottom, as
+    // load() stores it), e.g. from MazeGenerator. Info goes back to the
+    // defaults.
+    void setLayout(int new_width, int new_height, std::vector<TileType> new_tiles);
+    
+    // Spawns, ghost house and tunnels of the loaded level
+    const LevelInfo& getInfo() const { return info; }
+    void setInfo(const LevelInfo& new_info) { info = new_info; }
+    
     // Get tile at grid position
     TileType getTile(int x, int y) const;
     
@@ -43,6 +85,19 @@ public:
     // Check if position is walkable
     bool isWalkable(int x, int y) const;
     
+    // Tile index one step from (x, y) in dir, following tunnel wraps at
+    // open edges; NO_NEIGHBOUR if the step is blocked
+    static constexpr uint32_t NO_NEIGHBOUR = 0xFFFFFFFFu;
+    uint32_t getNeighbour(int x, int y, Direction dir) const {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(height) ||
+            static_cast<unsigned>(dir) >= 4u) return NO_NEIGHBOUR;
+        return links[y * width + x].next[static_cast<int>(dir)];
+    }
+    uint32_t getNeighbour(uint32_t index, Direction dir) const {
+        return links[index].next[static_cast<int>(dir)];
+    }
+    
     // Maze dimensions
     int getWidth() const { return width; }
     int getHeight() const { return height; }
@@ -50,16 +105,77 @@ public:
     // Get center of maze in world coordinates
     glm::vec3 getCenter() const;
     
+    // Shared BFS distance field toward one target tile (normally Pac-Man).
+    // Recomputed only when the target moves; every ghost reads the same field.
+    void updateDistanceField(int target_x, int target_y);
+    
+    // Path length to the field target (-1 if unreachable or not walkable)
+    int getFieldDistance(int x, int y) const;
+    
+    // First step of a shortest path to the field target (NONE if unreachable)
+    Direction getFieldDirection(int x, int y) const;
+    
+    // Tile the field currently points to ((-1, -1) if none)
+    glm::ivec2 getFieldTarget() const { return fieldTarget; }
+    
+    // Bitboard mirror of walkable/pellet/power tiles
+    const MazeBits& getBits() const { return bits; }
+    
+    // Pellets and power pellets left, by popcount
+    int getRemainingPellets() const;
+    
+    // True once every pellet and power pellet is eaten
+    bool isCleared() const;
+    
+    // Intersections and corridors of the walkable layout, built on load
+    const JunctionGraph& getJunctionGraph() const { return junctionGraph; }
+    
+    // Precomputed all-pairs paths for this layout (nullptr if not built).
+    // Dropped on load and whenever the walkable layout changes.
+    void setPathTable(std::shared_ptr<const PathTable> table) { pathTable = std::move(table); }
+    const PathTable* getPathTable() const { return pathTable.get(); }
+    
+    // Cluster hierarchy for large layouts (nullptr below HIERARCHY_MIN_TILES).
+    // Kept current through setTile, one cluster at a time.
+    const PathHierarchy* getHierarchy() const { return hierarchy.isBuilt() ? &hierarchy : nullptr; }
+    static constexpr int HIERARCHY_MIN_TILES = 64 * 64;
+    
     // Tile size in world units
     static constexpr float TILE_SIZE = 1.0f;
 
 private:
+    // Neighbour tile index per Direction, NO_NEIGHBOUR if blocked
+    struct TileLinks {
+        uint32_t next[4];
+    };
+    
     int width;
     int height;
     std::vector<TileType> tiles;
+    std::vector<TileLinks> links;
+    LevelInfo info;
+    
+    // Distance field state
+    std::vector<int> fieldDistance;
+    std::vector<Direction> fieldDirection;
+    glm::ivec2 fieldTarget;
+    
+    std::shared_ptr<const PathTable> pathTable;
+    JunctionGraph junctionGraph;
+    MazeBits bits;
+    PathHierarchy hierarchy;
     
     // Convert character to tile type
     TileType charToTile(char c) const;
+    
+    // Parse the text format, picking up spawn markers
+    bool parseText(const char* text, size_t size);
+    
+    // Rebuild the neighbour table and everything derived from the layout
+    void rebuildLayout();
+    
+    // Point the neighbours of (x, y) at it, or away from it
+    void relinkTile(int x, int y);
 };
 
 #endif // MAZE_H
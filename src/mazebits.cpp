@@ -0,0 +1,142 @@
+#include "mazebits.h"
+#include "maze.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    inline int popcount64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(value);
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX2__)
+        // POPCNT is guaranteed on every AVX2 CPU
+        return static_cast<int>(__popcnt64(value));
+#else
+        value = value - ((value >> 1) & 0x5555555555555555ull);
+        value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+        value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<int>((value * 0x0101010101010101ull) >> 56);
+#endif
+    }
+}
+
+MazeBits::MazeBits()
+    : width(0)
+    , height(0)
+    , valid(false)
+    , rowMask(0)
+{}
+
+void MazeBits::build(const Maze& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    valid = width > 0 && width <= MAX_WIDTH;
+    walkable.assign(valid ? height : 0, 0);
+    pellets.assign(valid ? height : 0, 0);
+    powers.assign(valid ? height : 0, 0);
+    if (!valid) return;
+
+    rowMask = (width == 64) ? ~0ull : ((1ull << width) - 1);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            TileType tile = maze.getTile(x, y);
+            uint64_t bit = 1ull << x;
+            if (tile == TileType::FLOOR || tile == TileType::PELLET ||
+                tile == TileType::POWER || tile == TileType::DOOR) walkable[y] |= bit;
+            if (tile == TileType::PELLET) pellets[y] |= bit;
+            if (tile == TileType::POWER) powers[y] |= bit;
+        }
+    }
+}
+
+void MazeBits::setTile(int x, int y, bool is_walkable, bool pellet, bool power) {
+    if (!valid || x < 0 || x >= width || y < 0 || y >= height) return;
+
+    uint64_t bit = 1ull << x;
+    walkable[y] = is_walkable ? (walkable[y] | bit) : (walkable[y] & ~bit);
+    pellets[y] = pellet ? (pellets[y] | bit) : (pellets[y] & ~bit);
+    powers[y] = power ? (powers[y] | bit) : (powers[y] & ~bit);
+}
+
+uint64_t MazeBits::getNeighbourRow(int y, Direction dir) const {
+    if (!valid || y < 0 || y >= height) return 0;
+
+    // Rows and columns wrap, matching the maze's tunnel links
+    uint64_t row = walkable[y];
+    switch (dir) {
+        case Direction::UP:    return row & walkable[(y + 1) % height];
+        case Direction::DOWN:  return row & walkable[(y + height - 1) % height];
+        case Direction::LEFT:  return row & ((row << 1) | (row >> (width - 1))) & rowMask;
+        case Direction::RIGHT: return row & ((row >> 1) | (row << (width - 1))) & rowMask;
+        default:               return 0;
+    }
+}
+
+int MazeBits::countBits(const std::vector<uint64_t>& rows) {
+    size_t count = rows.size();
+    size_t i = 0;
+    int total = 0;
+
+#if defined(__AVX2__)
+    // Nibble lookup popcount (Mula), four rows per iteration
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    __m256i sums = _mm256_setzero_si256();
+
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows.data() + i));
+        __m256i lo = _mm256_and_si256(v, lowNibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+    total = static_cast<int>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+
+    for (; i < count; i++) {
+        total += popcount64(rows[i]);
+    }
+    return total;
+}
+
+int MazeBits::countPellets() const {
+    return countBits(pellets);
+}
+
+int MazeBits::countPowers() const {
+    return countBits(powers);
+}
+
+bool MazeBits::isCleared() const {
+    if (!valid) return false;
+
+    size_t count = pellets.size();
+    size_t i = 0;
+    uint64_t any = 0;
+
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pellets.data() + i));
+        __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(powers.data() + i));
+        acc = _mm256_or_si256(acc, _mm256_or_si256(p, q));
+    }
+    if (!_mm256_testz_si256(acc, acc)) return false;
+#endif
+
+    for (; i < count; i++) {
+        any |= pellets[i] | powers[i];
+    }
+    return any == 0;
+}
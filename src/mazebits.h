@@ -0,0 +1,66 @@
+#ifndef MAZEBITS_H
+#define MAZEBITS_H
+
+#include <cstdint>
+#include <vector>
+#include "entity.h"
+
+class Maze;
+
+/**
+ * Bitboard mirror of the maze: one 64-bit word per row (bit x = column x)
+ * for walkable, pellet and power tiles. Counting and clear checks run
+ * over whole rows, with AVX2 kernels when compiled for it and a scalar
+ * fallback otherwise. Mazes wider than 64 tiles leave the boards
+ * invalid and callers fall back to the tile array.
+ */
+class MazeBits {
+public:
+    static constexpr int MAX_WIDTH = 64;
+
+    MazeBits();
+
+    // Rebuild all boards from the maze's tiles
+    void build(const Maze& maze);
+
+    // Keep the boards in sync with a single tile change
+    void setTile(int x, int y, bool walkable, bool pellet, bool power);
+
+    bool isValid() const { return valid; }
+
+    bool isWalkable(int x, int y) const {
+        // Unsigned compares fold the four bounds checks into two
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(height)) return false;
+        return (walkable[y] >> x) & 1u;
+    }
+
+    // Walkable tiles of row y whose neighbour in dir (wrapping at the
+    // edges like tunnels) is also walkable
+    uint64_t getNeighbourRow(int y, Direction dir) const;
+
+    // Popcount over all rows
+    int countPellets() const;
+    int countPowers() const;
+
+    // True once no pellet or power pellet is left (O(rows))
+    bool isCleared() const;
+
+    const std::vector<uint64_t>& getWalkableRows() const { return walkable; }
+    const std::vector<uint64_t>& getPelletRows() const { return pellets; }
+    const std::vector<uint64_t>& getPowerRows() const { return powers; }
+
+private:
+    int width;
+    int height;
+    bool valid;
+    uint64_t rowMask;
+
+    std::vector<uint64_t> walkable;
+    std::vector<uint64_t> pellets;
+    std::vector<uint64_t> powers;
+
+    static int countBits(const std::vector<uint64_t>& rows);
+};
+
+#endif // MAZEBITS_H
@@ -0,0 +1,406 @@
+#include "mazegen.h"
+#include "levelfile.h"
+#include "pathtable.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+namespace {
+    bool isOpen(TileType tile) {
+        return tile == TileType::FLOOR || tile == TileType::PELLET ||
+               tile == TileType::POWER || tile == TileType::DOOR;
+    }
+}
+
+MazeGenerator::MazeGenerator() : MazeGenerator(Params()) {}
+
+MazeGenerator::MazeGenerator(const Params& new_params)
+    : params(new_params)
+    , width(0)
+    , height(0)
+    , cols(0)
+    , rows(0)
+    , houseRow(0)
+    , gates(nullptr)
+{
+    params.crossings = std::min(std::max(params.crossings, 0.0f), 1.0f);
+    params.loops = std::min(std::max(params.loops, 0.0f), 1.0f);
+    params.tunnels = std::max(params.tunnels, 0);
+    params.powerPellets = std::max(params.powerPellets, 0) & ~1;
+    setFrame();
+}
+
+void MazeGenerator::setFrame() {
+    width = std::max(params.width, MIN_WIDTH) & ~3;
+    height = std::max(params.height, MIN_HEIGHT);
+    if ((height & 1) == 0) height--;
+
+    // Cells sit on odd tiles; the last left-half column is next to its
+    // own mirror, so a cell there is a crossing of the centre line
+    cols = width / 4;
+    rows = (height - 1) / 2;
+    houseRow = (height / 2) & ~1;
+
+    // House walls span tiles [w/2 - 4, w/2 + 3] x [houseRow - 2, houseRow + 2]
+    size_t cells = static_cast<size_t>(cols) * rows;
+    reserved.assign(cells, 0);
+    for (int cy = (houseRow - 2) / 2; cy <= houseRow / 2; cy++) {
+        reserved[cell(cols - 2, cy)] = 1;
+        reserved[cell(cols - 1, cy)] = 1;
+    }
+}
+
+int MazeGenerator::find(int c) {
+    while (parent[c] != c) {
+        parent[c] = parent[parent[c]];
+        c = parent[c];
+    }
+    return c;
+}
+
+bool MazeGenerator::join(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    parent[b] = a;
+    return true;
+}
+
+void MazeGenerator::openBridge(int cy) {
+    if (reserved[cell(cols - 1, cy)]) return;
+    used[cell(cols - 1, cy)] = 1;
+    open[cell(cols - 2, cy)] |= OPEN_RIGHT;
+    join(cell(cols - 2, cy), cell(cols - 1, cy));
+}
+
+void MazeGenerator::carve() {
+    size_t cells = static_cast<size_t>(cols) * rows;
+    open.assign(cells, 0);
+    used.assign(cells, 0);
+    parent.resize(cells);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (int cy = 0; cy < rows; cy++) {
+        for (int cx = 0; cx < cols - 1; cx++) {
+            if (!reserved[cell(cx, cy)]) used[cell(cx, cy)] = 1;
+        }
+    }
+
+    // Tunnels go on rows clear of the outer corridors and the house
+    tunnel.assign(rows, 0);
+    bottomGate.assign(cols, 0);
+    topGate.assign(cols, 0);
+    if (gates) {
+        for (int cy = 0; cy < rows && cy < 64; cy++) {
+            int y = 2 * cy + 1;
+            if (((gates->sides >> cy) & 1) && (y < houseRow - 3 || y > houseRow + 3)) tunnel[cy] = 1;
+        }
+        for (int cx = 0; cx < cols - 1 && cx < 64; cx++) {
+            bottomGate[cx] = (gates->bottom >> cx) & 1;
+            topGate[cx] = (gates->top >> cx) & 1;
+        }
+    } else {
+        queue.clear();
+        for (int cy = 1; cy < rows - 1; cy++) {
+            int y = 2 * cy + 1;
+            if (y < houseRow - 3 || y > houseRow + 3) queue.push_back(static_cast<uint32_t>(cy));
+        }
+        for (int t = 0; t < params.tunnels && !queue.empty(); t++) {
+            size_t pick = rng.next() % queue.size();
+            tunnel[queue[pick]] = 1;
+            queue[pick] = queue.back();
+            queue.pop_back();
+        }
+    }
+
+    // Ring corridor around the house, crossing the centre above and below
+    const int ringLow = (houseRow - 4) / 2;
+    const int ringHigh = (houseRow + 2) / 2;
+    for (int cy = ringLow; cy < ringHigh; cy++) {
+        open[cell(cols - 3, cy)] |= OPEN_UP;
+        join(cell(cols - 3, cy), cell(cols - 3, cy + 1));
+    }
+    for (int cy : {ringLow, ringHigh}) {
+        open[cell(cols - 3, cy)] |= OPEN_RIGHT;
+        join(cell(cols - 3, cy), cell(cols - 2, cy));
+        openBridge(cy);
+    }
+
+    // The lower ring crossing is Pac-Man's spawn; other rows cross at random
+    for (int cy = 0; cy < rows; cy++) {
+        if (!used[cell(cols - 1, cy)] && chance(params.crossings)) openBridge(cy);
+    }
+
+    // Random spanning tree over the rest (Kruskal)
+    edges.clear();
+    for (int cy = 0; cy < rows; cy++) {
+        for (int cx = 0; cx < cols - 1; cx++) {
+            int c = cell(cx, cy);
+            if (!used[c]) continue;
+            if (cx + 1 < cols - 1 && used[cell(cx + 1, cy)] && !(open[c] & OPEN_RIGHT)) {
+                edges.push_back(static_cast<uint32_t>(c) * 2);
+            }
+            if (cy + 1 < rows && used[cell(cx, cy + 1)] && !(open[c] & OPEN_UP)) {
+                edges.push_back(static_cast<uint32_t>(c) * 2 + 1);
+            }
+        }
+    }
+    for (size_t i = edges.size(); i > 1; i--) {
+        std::swap(edges[i - 1], edges[rng.next() % i]);
+    }
+    size_t kept = 0;
+    for (uint32_t edge : edges) {
+        int c = static_cast<int>(edge >> 1);
+        bool up = edge & 1;
+        if (join(c, up ? c + cols : c + 1)) open[c] |= up ? OPEN_UP : OPEN_RIGHT;
+        else edges[kept++] = edge;
+    }
+    edges.resize(kept);
+}
+
+int MazeGenerator::degree(int cx, int cy) const {
+    int c = cell(cx, cy);
+    int links = 0;
+    if (open[c] & OPEN_RIGHT) links++;
+    if (open[c] & OPEN_UP) links++;
+    if (cx > 0 && (open[c - 1] & OPEN_RIGHT)) links++;
+    if (cy > 0 && (open[c - cols] & OPEN_UP)) links++;
+    if (cx == cols - 1) links++;                // the mirror cell
+    if (cx == 0 && tunnel[cy]) links++;         // the far edge
+    if (cy == 0 && bottomGate[cx]) links++;
+    if (cy == rows - 1 && topGate[cx]) links++;
+    return links;
+}
+
+void MazeGenerator::braid() {
+    // Knock through from every dead end, preferring another dead end
+    for (int cy = 0; cy < rows; cy++) {
+        for (int cx = 0; cx < cols - 1; cx++) {
+            if (!used[cell(cx, cy)] || degree(cx, cy) > 1) continue;
+
+            // Candidate walls as (cell, side), dead-end neighbours first
+            uint32_t options[4];
+            int count = 0;
+            int preferred = 0;
+            auto consider = [&](int nx, int ny, int from, uint8_t side) {
+                if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) return;
+                int n = cell(nx, ny);
+                if (reserved[n] || (open[from] & side)) return;
+                if (side == OPEN_UP && nx == cols - 1) return;
+                uint32_t option = static_cast<uint32_t>(from) * 2 + (side == OPEN_UP ? 1 : 0);
+                if (used[n] && nx != cols - 1 && degree(nx, ny) == 1) {
+                    options[count++] = options[preferred];
+                    options[preferred++] = option;
+                } else {
+                    options[count++] = option;
+                }
+            };
+            int c = cell(cx, cy);
+            consider(cx + 1, cy, c, OPEN_RIGHT);
+            consider(cx, cy + 1, c, OPEN_UP);
+            if (cx > 0) consider(cx - 1, cy, c - 1, OPEN_RIGHT);
+            if (cy > 0) consider(cx, cy - 1, c - cols, OPEN_UP);
+            if (count == 0) continue;
+
+            uint32_t option = options[rng.next() % (preferred > 0 ? preferred : count)];
+            int from = static_cast<int>(option >> 1);
+            bool up = option & 1;
+            open[from] |= up ? OPEN_UP : OPEN_RIGHT;
+            used[up ? from + cols : from + 1] = 1;
+        }
+    }
+
+    // A few extra loops through walls the tree left standing
+    for (uint32_t edge : edges) {
+        int c = static_cast<int>(edge >> 1);
+        if (chance(params.loops)) open[c] |= (edge & 1) ? OPEN_UP : OPEN_RIGHT;
+    }
+}
+
+void MazeGenerator::paint(std::vector<TileType>& tiles) const {
+    tiles.assign(static_cast<size_t>(width) * height, TileType::WALL);
+    auto set = [&](int x, int y, TileType type) {
+        tiles[y * width + x] = type;
+        tiles[y * width + width - 1 - x] = type;
+    };
+
+    for (int cy = 0; cy < rows; cy++) {
+        int y = 2 * cy + 1;
+        for (int cx = 0; cx < cols; cx++) {
+            int c = cell(cx, cy);
+            if (!used[c]) continue;
+            int x = 2 * cx + 1;
+            set(x, y, TileType::PELLET);
+            if (open[c] & OPEN_RIGHT) set(x + 1, y, TileType::PELLET);
+            if (open[c] & OPEN_UP) set(x, y + 1, TileType::PELLET);
+        }
+        if (tunnel[cy]) set(0, y, TileType::PELLET);
+    }
+    for (int cx = 0; cx < cols - 1; cx++) {
+        if (bottomGate[cx]) set(2 * cx + 1, 0, TileType::PELLET);
+        if (topGate[cx]) set(2 * cx + 1, height - 1, TileType::PELLET);
+    }
+
+    // Ghost house: walls, an empty floor and a door on top
+    const int centre = width / 2;
+    for (int y = houseRow - 2; y <= houseRow + 2; y++) {
+        for (int x = centre - 4; x < centre; x++) {
+            bool inside = x > centre - 4 && y > houseRow - 2 && y < houseRow + 2;
+            set(x, y, inside ? TileType::FLOOR : TileType::WALL);
+        }
+    }
+    set(centre - 1, houseRow + 2, TileType::DOOR);
+}
+
+void MazeGenerator::placePowerPellets(std::vector<TileType>& tiles) {
+    // Half above the house and half below, mirrored, away from the ghost
+    // corners (the tree edges and queue are free scratch by now)
+    std::vector<uint32_t>& upper = edges;
+    std::vector<uint32_t>& lower = queue;
+    upper.clear();
+    lower.clear();
+    for (int cy = 0; cy < rows; cy++) {
+        int y = 2 * cy + 1;
+        if (y >= houseRow - 3 && y <= houseRow + 3) continue;
+        for (int cx = 0; cx < cols - 1; cx++) {
+            if (!used[cell(cx, cy)]) continue;
+            if (cx == 0 && (cy == 0 || cy == rows - 1)) continue;
+            uint32_t tile = static_cast<uint32_t>(y * width + 2 * cx + 1);
+            (y > houseRow ? upper : lower).push_back(tile);
+        }
+    }
+
+    for (int i = 0; i < params.powerPellets / 2; i++) {
+        std::vector<uint32_t>& side = (i & 1) ? lower : upper;
+        if (side.empty()) continue;
+        size_t pick = rng.next() % side.size();
+        uint32_t tile = side[pick];
+        side[pick] = side.back();
+        side.pop_back();
+        int x = static_cast<int>(tile % width);
+        int y = static_cast<int>(tile / width);
+        tiles[tile] = TileType::POWER;
+        tiles[y * width + width - 1 - x] = TileType::POWER;
+    }
+}
+
+bool MazeGenerator::isPlayable(const std::vector<TileType>& tiles) {
+    // Neighbours wrap at open edges, as in Maze. A gate's way out counts
+    // as an exit even if the tile it wraps to is a wall.
+    auto neighbour = [&](int index, int d) {
+        int x = index % width;
+        int y = index / width;
+        glm::ivec2 offset = Entity::getDirectionOffset(static_cast<Direction>(d));
+        return ((y + offset.y + height) % height) * width + (x + offset.x + width) % width;
+    };
+
+    int walkable = 0;
+    for (int i = 0; i < width * height; i++) {
+        if (!isOpen(tiles[i])) continue;
+        walkable++;
+        int x = i % width;
+        int y = i / width;
+        int exits = 0;
+        for (int d = 0; d < 4; d++) {
+            glm::ivec2 offset = Entity::getDirectionOffset(static_cast<Direction>(d));
+            bool outside = x + offset.x < 0 || x + offset.x >= width || y + offset.y < 0 || y + offset.y >= height;
+            if ((outside && gates) || isOpen(tiles[neighbour(i, d)])) exits++;
+        }
+        if (exits < 2) return false;
+    }
+
+    seen.assign(tiles.size(), 0);
+    queue.clear();
+    int start = width + 1;
+    if (!isOpen(tiles[start])) return false;
+    seen[start] = 1;
+    queue.push_back(static_cast<uint32_t>(start));
+    for (size_t head = 0; head < queue.size(); head++) {
+        for (int d = 0; d < 4; d++) {
+            int next = neighbour(static_cast<int>(queue[head]), d);
+            if (seen[next] || !isOpen(tiles[next])) continue;
+            seen[next] = 1;
+            queue.push_back(static_cast<uint32_t>(next));
+        }
+    }
+    return static_cast<int>(queue.size()) == walkable;
+}
+
+bool MazeGenerator::generateTiles(uint64_t seed, int& out_width, int& out_height, std::vector<TileType>& tiles) {
+    return run(nullptr, seed, out_width, out_height, tiles);
+}
+
+bool MazeGenerator::generateTiles(uint64_t seed, const Gates& new_gates, int& out_width, int& out_height,
+                                  std::vector<TileType>& tiles) {
+    return run(&new_gates, seed, out_width, out_height, tiles);
+}
+
+bool MazeGenerator::run(const Gates* new_gates, uint64_t seed, int& out_width, int& out_height,
+                        std::vector<TileType>& tiles) {
+    gates = new_gates;
+    bool ok = false;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS && !ok; attempt++) {
+        rng.seed(seed + static_cast<uint64_t>(attempt) * 0x9E3779B97F4A7C15ull);
+        carve();
+        braid();
+        paint(tiles);
+        placePowerPellets(tiles);
+        ok = isPlayable(tiles);
+    }
+    gates = nullptr;
+    if (ok) {
+        out_width = width;
+        out_height = height;
+    }
+    return ok;
+}
+
+bool MazeGenerator::generate(uint64_t seed, Maze& maze) {
+    int w = 0;
+    int h = 0;
+    std::vector<TileType> tiles;
+    if (!generateTiles(seed, w, h, tiles)) return false;
+    maze.setLayout(w, h, std::move(tiles));
+
+    // Ghosts in the inner corners, Pac-Man on the centre crossing below
+    // the house (the ring always opens it); the rest comes from the layout
+    LevelInfo info;
+    info.pacmanSpawn = glm::ivec2(w / 2, houseRow - 3);
+    info.ghostSpawns[0] = glm::ivec2(1, h - 2);
+    info.ghostSpawns[1] = glm::ivec2(w - 2, h - 2);
+    info.ghostSpawns[2] = glm::ivec2(1, 1);
+    info.ghostSpawns[3] = glm::ivec2(w - 2, 1);
+    LevelFile::describe(maze, info);
+    maze.setInfo(info);
+
+    std::vector<std::string> problems = LevelFile::validate(maze);
+    for (const std::string& problem : problems) {
+        std::cerr << "ERROR::MAZEGEN: Seed " << seed << ": " << problem << std::endl;
+    }
+    return problems.empty();
+}
+
+void MazeGenerator::generateMany(const Params& params, uint64_t first_seed, size_t count,
+                                 std::vector<Maze>& out, ThreadPool& pool) {
+    out.resize(count);
+    std::vector<MazeGenerator> generators(pool.getThreadCount(), MazeGenerator(params));
+    pool.parallelFor(count, 1, [&](size_t begin, size_t end, unsigned int worker) {
+        for (size_t i = begin; i < end; i++) {
+            if (!generators[worker].generate(first_seed + i, out[i])) out[i] = Maze();
+        }
+    });
+}
+
+std::future<Maze> MazeGenerator::generateAsync(const Params& params, uint64_t seed, bool path_table) {
+    return std::async(std::launch::async, [params, seed, path_table]() {
+        Maze maze;
+        MazeGenerator generator(params);
+        if (generator.generate(seed, maze) && path_table) {
+            auto table = std::make_shared<PathTable>();
+            if (table->build(maze, 1)) maze.setPathTable(table);
+        }
+        return maze;
+    });
+}
@@ -0,0 +1,123 @@
+#ifndef MAZEGEN_H
+#define MAZEGEN_H
+
+#include <cstdint>
+#include <future>
+#include <vector>
+#include "maze.h"
+#include "simrandom.h"
+
+class ThreadPool;
+
+/**
+ * Seeded generator for Pac-Man style mazes.
+ *
+ * The left half is carved on a grid of cells (odd tiles, walls between)
+ * as a random spanning tree, then braided so no corridor dead-ends, and
+ * mirrored onto the right half. A walled ghost house with a door sits in
+ * the middle inside a ring corridor. Rows may cross the centre line, and
+ * tunnel rows open onto both side edges and wrap.
+ *
+ * Ghosts spawn in the four inner corners and Pac-Man on the centre
+ * crossing just below the house, whatever the frame size. Every result
+ * is checked to be fully connected, and generate() also runs it through
+ * LevelFile::validate.
+ *
+ * The same seed and params always give the same maze. A generator keeps
+ * scratch buffers between calls; use one per thread.
+ */
+class MazeGenerator {
+public:
+    struct Params {
+        int width = 28;             // rounded down to a multiple of 4
+        int height = 25;            // rounded down to an odd number
+        int tunnels = 1;            // wrapping rows
+        int powerPellets = 4;       // rounded down to an even number
+        float crossings = 0.3f;     // chance a row crosses the centre line
+        float loops = 0.1f;         // chance each leftover inner wall is opened
+    };
+
+    // Openings through the outer wall for mazes that tile a larger world
+    // (ChunkWorld). Bit i opens cell row/column i (tile 2i + 1). Side gates
+    // replace the random tunnels and, like bottom/top ones, are mirrored;
+    // rows through the ghost house and the centre column are skipped.
+    struct Gates {
+        uint64_t sides = 0;
+        uint64_t bottom = 0;
+        uint64_t top = 0;
+    };
+
+    static constexpr int MIN_WIDTH = 20;
+    static constexpr int MIN_HEIGHT = 15;
+    static constexpr int MAX_ATTEMPTS = 8;
+
+    MazeGenerator();
+    explicit MazeGenerator(const Params& params);
+
+    const Params& getParams() const { return params; }
+
+    // Build the maze for seed straight into the maze's tile storage, with
+    // its spawns, ghost house and tunnels. False if no connected layout
+    // came out in MAX_ATTEMPTS tries or the result failed validation.
+    bool generate(uint64_t seed, Maze& maze);
+
+    // Tiles only (row-major, y = 0 at the bottom like Maze::load)
+    bool generateTiles(uint64_t seed, int& width, int& height, std::vector<TileType>& tiles);
+    bool generateTiles(uint64_t seed, const Gates& gates, int& width, int& height, std::vector<TileType>& tiles);
+
+    // Frame size the params round to
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Mazes for seeds first_seed .. first_seed + count - 1 across the pool
+    static void generateMany(const Params& params, uint64_t first_seed, size_t count,
+                             std::vector<Maze>& out, ThreadPool& pool);
+
+    // Generate on a background thread, with the path table built too if
+    // asked, so the maze is ready to play when the future is. The maze is
+    // empty (width 0) if generation failed.
+    static std::future<Maze> generateAsync(const Params& params, uint64_t seed, bool path_table = true);
+
+private:
+    // Cell sides with an opening (toward +x, toward +y)
+    static constexpr uint8_t OPEN_RIGHT = 1;
+    static constexpr uint8_t OPEN_UP = 2;
+
+    Params params;
+    int width;
+    int height;
+    int cols;       // cell columns in the left half; the last one touches its mirror
+    int rows;
+    int houseRow;   // tile row through the middle of the ghost house
+
+    SimRandom rng;
+    std::vector<uint8_t> open;          // per cell
+    std::vector<uint8_t> used;          // per cell: part of the maze
+    std::vector<uint8_t> reserved;      // per cell: covered by the ghost house
+    std::vector<uint8_t> tunnel;        // per cell row
+    std::vector<uint8_t> bottomGate;    // per cell column
+    std::vector<uint8_t> topGate;
+    const Gates* gates;                 // for the current call, or nullptr
+    std::vector<int> parent;            // union-find over cells
+    std::vector<uint32_t> edges;        // cell * 2 + (0 = right, 1 = up)
+    std::vector<uint32_t> queue;
+    std::vector<uint8_t> seen;          // per tile, for the connectivity check
+
+    int cell(int cx, int cy) const { return cy * cols + cx; }
+    bool chance(float p) { return (rng.next() >> 8) < static_cast<uint32_t>(p * 16777216.0f); }
+    int find(int c);
+    bool join(int a, int b);
+
+    void setFrame();
+    bool run(const Gates* gates, uint64_t seed, int& width, int& height, std::vector<TileType>& tiles);
+    void openBridge(int cy);
+    void carve();
+    void braid();
+    int degree(int cx, int cy) const;
+    void paint(std::vector<TileType>& tiles) const;
+    void placePowerPellets(std::vector<TileType>& tiles);
+    // Every walkable tile reachable from a ghost corner, and none a dead end
+    bool isPlayable(const std::vector<TileType>& tiles);
+};
+
+#endif // MAZEGEN_H
@@ -0,0 +1,292 @@
+#include "mctsbot.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const Direction ALL_DIRECTIONS[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+    // The search steps at the game's fixed tick rate
+    const float SEARCH_DT = 1.0f / 120.0f;
+
+    double nowSeconds() {
+        return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+    }
+
+    int countMoves(uint8_t moves) {
+        int count = 0;
+        for (; moves; moves &= moves - 1) count++;
+        return count;
+    }
+
+    // The n-th set bit of moves
+    Direction pickMove(uint8_t moves, uint32_t n) {
+        for (int dir = 0; dir < 4; dir++) {
+            if (!((moves >> dir) & 1u)) continue;
+            if (n-- == 0) return static_cast<Direction>(dir);
+        }
+        return Direction::NONE;
+    }
+}
+
+MctsBot::MctsBot(double budget_ms, unsigned int threads, uint64_t seed)
+    : budgetMs(budget_ms)
+    , seed(seed)
+    , pool(std::make_unique<ThreadPool>(threads))
+{}
+
+MctsBot::~MctsBot() = default;
+
+void MctsBot::reset() {
+    // Workers re-clone on the next search, in case the level changed
+    workers.clear();
+}
+
+Direction MctsBot::getInput(const Simulation& sim, uint64_t) {
+    const PacMan& pacman = sim.pacman;
+    if (pacman.is_moving || pacman.isDead || sim.gameOver) return Direction::NONE;
+
+    uint8_t moves = legalMoves(sim);
+    if (countMoves(moves) <= 1) return pickMove(moves, 0);
+
+    if (workers.empty()) {
+        workers.resize(pool->getThreadCount());
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].sim = std::make_unique<Simulation>(sim);
+            workers[i].sim->setLogging(false);
+            workers[i].sim->events.clear();
+            workers[i].rng.seed(seed + i);
+        }
+    }
+
+    SimState root;
+    sim.saveState(root);
+    buildPelletDistance(sim.maze);
+
+    double start = nowSeconds();
+    double deadline = start + budgetMs / 1000.0;
+    pool->parallelFor(workers.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) search(workers[i], root, deadline);
+    });
+
+    // Most visited move over all trees; the mean value breaks ties
+    uint32_t visits[4] = {};
+    float values[4] = {};
+    for (Worker& worker : workers) {
+        const Node& rootNode = worker.tree[0];
+        for (int dir = 0; dir < 4; dir++) {
+            int32_t child = rootNode.children[dir];
+            if (child < 0) continue;
+            visits[dir] += worker.tree[child].visits;
+            values[dir] += worker.tree[child].valueSum;
+        }
+
+        stats.nodes += worker.nodes;
+        stats.rollouts += worker.rollouts;
+        stats.simTicks += worker.simTicks;
+        worker.nodes = worker.rollouts = worker.simTicks = 0;
+    }
+    stats.decisions++;
+    stats.seconds += nowSeconds() - start;
+
+    Direction best = pickMove(moves, 0);
+    for (int dir = 0; dir < 4; dir++) {
+        int b = static_cast<int>(best);
+        if (visits[dir] > visits[b] ||
+            (visits[dir] == visits[b] && visits[dir] > 0 && values[dir] / visits[dir] > values[b] / visits[b])) {
+            best = static_cast<Direction>(dir);
+        }
+    }
+    return best;
+}
+
+void MctsBot::search(Worker& worker, const SimState& root, double deadline_seconds) const {
+    Simulation& sim = *worker.sim;
+    const int startScore = root.pacman.score;
+    const int startLives = root.pacman.lives;
+
+    sim.loadState(root);
+    const int startDistance = pelletDistance[sim.pacman.grid_y * sim.maze.getWidth() + sim.pacman.grid_x];
+    worker.tree.clear();
+    addNode(worker, -1, sim);
+
+    for (uint32_t iteration = 0; ; iteration++) {
+        if ((iteration & 15u) == 0 && nowSeconds() >= deadline_seconds) break;
+        sim.loadState(root);
+
+        // Selection: descend by UCB1 through fully expanded nodes
+        int32_t node = 0;
+        while (!worker.tree[node].terminal && worker.tree[node].untried == 0) {
+            const Node& current = worker.tree[node];
+            float logVisits = std::log(static_cast<float>(current.visits));
+            int32_t bestChild = -1;
+            Direction bestDir = Direction::NONE;
+            float bestScore = -1.0f;
+            for (int dir = 0; dir < 4; dir++) {
+                int32_t child = current.children[dir];
+                if (child < 0) continue;
+                const Node& next = worker.tree[child];
+                float score = next.valueSum / next.visits + EXPLORATION * std::sqrt(logVisits / next.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestChild = child;
+                    bestDir = static_cast<Direction>(dir);
+                }
+            }
+            if (bestChild < 0) break;
+            advance(worker, sim, bestDir);
+            node = bestChild;
+        }
+
+        // Expansion: one untried move
+        if (!worker.tree[node].terminal && worker.tree[node].untried != 0) {
+            uint8_t untried = worker.tree[node].untried;
+            Direction dir = pickMove(untried, worker.rng.next() % countMoves(untried));
+            worker.tree[node].untried &= static_cast<uint8_t>(~(1u << static_cast<int>(dir)));
+            advance(worker, sim, dir);
+
+            int32_t child = addNode(worker, node, sim);
+            worker.tree[node].children[static_cast<int>(dir)] = child;
+            node = child;
+        }
+
+        for (int depth = 0; depth < ROLLOUT_DEPTH; depth++) {
+            if (sim.gameOver || sim.pacman.lives < startLives) break;
+            uint8_t moves = rolloutMoves(sim);
+            if (moves == 0) break;
+            advance(worker, sim, pickMove(moves, worker.rng.next() % countMoves(moves)));
+        }
+        worker.rollouts++;
+
+        float value = evaluate(sim, startScore, startLives, startDistance);
+        for (int32_t n = node; n >= 0; n = worker.tree[n].parent) {
+            worker.tree[n].visits++;
+            worker.tree[n].valueSum += value;
+        }
+    }
+}
+
+int32_t MctsBot::addNode(Worker& worker, int32_t parent, const Simulation& sim) const {
+    Node node;
+    node.parent = parent;
+    for (int32_t& child : node.children) child = -1;
+    node.terminal = sim.gameOver || (parent >= 0 && sim.pacman.isDead);
+    node.untried = node.terminal ? 0 : legalMoves(sim);
+    node.visits = 0;
+    node.valueSum = 0.0f;
+
+    worker.tree.push_back(node);
+    worker.nodes++;
+    return static_cast<int32_t>(worker.tree.size() - 1);
+}
+
+void MctsBot::buildPelletDistance(const Maze& maze) {
+    // Multi-source BFS out from every pellet left
+    const int width = maze.getWidth();
+    pelletDistance.assign(static_cast<size_t>(width) * maze.getHeight(), -1);
+    std::vector<uint32_t> queue;
+    for (int y = 0; y < maze.getHeight(); y++) {
+        for (int x = 0; x < width; x++) {
+            TileType tile = maze.getTile(x, y);
+            if (tile != TileType::PELLET && tile != TileType::POWER) continue;
+            pelletDistance[y * width + x] = 0;
+            queue.push_back(static_cast<uint32_t>(y * width + x));
+        }
+    }
+    for (size_t head = 0; head < queue.size(); head++) {
+        for (Direction dir : ALL_DIRECTIONS) {
+            uint32_t next = maze.getNeighbour(queue[head], dir);
+            if (next == Maze::NO_NEIGHBOUR || pelletDistance[next] >= 0) continue;
+            pelletDistance[next] = pelletDistance[queue[head]] + 1;
+            queue.push_back(next);
+        }
+    }
+}
+
+void MctsBot::advance(Worker& worker, Simulation& sim, Direction dir) {
+    int ticks = 0;
+    do {
+        sim.step(SEARCH_DT, ticks == 0 ? dir : Direction::NONE);
+        ticks++;
+    } while (sim.pacman.is_moving && !sim.pacman.isDead && !sim.gameOver && ticks < MAX_TICKS_PER_MOVE);
+
+    sim.events.clear();
+    worker.simTicks += ticks;
+}
+
+uint8_t MctsBot::legalMoves(const Simulation& sim) {
+    uint8_t moves = 0;
+    for (Direction dir : ALL_DIRECTIONS) {
+        if (sim.maze.getNeighbour(sim.pacman.grid_x, sim.pacman.grid_y, dir) != Maze::NO_NEIGHBOUR) {
+            moves |= static_cast<uint8_t>(1u << static_cast<int>(dir));
+        }
+    }
+    return moves;
+}
+
+uint8_t MctsBot::rolloutMoves(const Simulation& sim) const {
+    const Maze& maze = sim.maze;
+    const PacMan& pacman = sim.pacman;
+    uint8_t moves = legalMoves(sim);
+
+    // Don't turn back unless it is the only way out. The distances go
+    // stale as a rollout eats, and this keeps it from pacing on the spot
+    Direction back = Entity::getOppositeDirection(pacman.current_dir);
+    uint8_t forward = moves;
+    if (back != Direction::NONE) forward &= static_cast<uint8_t>(~(1u << static_cast<int>(back)));
+    if (forward) moves = forward;
+
+    // Avoid stepping next to a ghost that can kill, then prefer pellets,
+    // then the steps that bring the nearest one closer
+    uint8_t safe = 0;
+    uint8_t food = 0;
+    uint8_t closer = 0;
+    int closest = -1;
+    for (int dir = 0; dir < 4; dir++) {
+        if (!((moves >> dir) & 1u)) continue;
+        uint32_t next = maze.getNeighbour(pacman.grid_x, pacman.grid_y, static_cast<Direction>(dir));
+        int x = static_cast<int>(next % maze.getWidth());
+        int y = static_cast<int>(next / maze.getWidth());
+
+        bool danger = false;
+        for (const Ghost& ghost : sim.ghosts) {
+            if (ghost.isEaten || ghost.mode == GhostMode::FRIGHTENED) continue;
+            if (Ghost::manhattanDistance(glm::ivec2(ghost.grid_x, ghost.grid_y), glm::ivec2(x, y)) <= 1) danger = true;
+        }
+        if (danger) continue;
+
+        safe |= static_cast<uint8_t>(1u << dir);
+        TileType tile = maze.getTile(x, y);
+        if (tile == TileType::PELLET || tile == TileType::POWER) food |= static_cast<uint8_t>(1u << dir);
+
+        int distance = pelletDistance[next];
+        if (distance < 0) continue;
+        if (closest < 0 || distance < closest) {
+            closest = distance;
+            closer = 0;
+        }
+        if (distance == closest) closer |= static_cast<uint8_t>(1u << dir);
+    }
+    if (food) return food;
+    if (closer) return closer;
+    return safe ? safe : moves;
+}
+
+float MctsBot::evaluate(const Simulation& sim, int start_score, int start_lives, int start_distance) const {
+    if (sim.pacman.lives < start_lives) return 0.0f;
+    if (sim.levelCleared) return 1.0f;
+    float gained = static_cast<float>(sim.pacman.score - start_score);
+    float value = 0.5f + 0.4f * std::min(1.0f, gained / REWARD_SCALE);
+
+    // Rollouts that eat nothing all score the same; reward the share of
+    // the way to the root's nearest pellet covered, however far it is
+    int distance = pelletDistance[sim.pacman.grid_y * sim.maze.getWidth() + sim.pacman.grid_x];
+    if (start_distance > 0 && distance >= 0) {
+        value += 0.1f * std::max(0.0f, 1.0f - static_cast<float>(distance) / start_distance);
+    }
+    return value;
+}
@@ -0,0 +1,97 @@
+#ifndef MCTSBOT_H
+#define MCTSBOT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "simbot.h"
+#include "simrandom.h"
+#include "simstate.h"
+
+class Maze;
+class Simulation;
+class ThreadPool;
+
+/**
+ * Monte Carlo tree search over the real game rules. At every tile where
+ * Pac-Man has to choose, each worker restores the current SimState into
+ * its own Simulation and grows a private tree (UCT selection, cheap
+ * rollouts that head for the nearest pellet) until the time budget runs
+ * out; the root visit counts are then summed across workers to pick the
+ * move.
+ *
+ * One tree step is one tile of Pac-Man movement, so depth is measured in
+ * decisions rather than ticks.
+ */
+class MctsBot : public InputSource {
+public:
+    // Totals since construction (or resetStats)
+    struct Stats {
+        uint64_t decisions = 0;
+        uint64_t nodes = 0;      // tree nodes expanded
+        uint64_t rollouts = 0;
+        uint64_t simTicks = 0;   // Simulation::step calls made by the search
+        double seconds = 0.0;    // wall time spent searching
+    };
+
+    // budget_ms per decision; 0 threads = one per hardware thread
+    explicit MctsBot(double budget_ms = 10.0, unsigned int threads = 0, uint64_t seed = 1);
+    ~MctsBot() override;
+
+    Direction getInput(const Simulation& sim, uint64_t tick) override;
+    void reset() override;
+
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats(); }
+    double getNodesPerSecond() const { return stats.seconds > 0.0 ? stats.nodes / stats.seconds : 0.0; }
+
+    static constexpr int ROLLOUT_DEPTH = 8;       // decisions per rollout
+    static constexpr int MAX_TICKS_PER_MOVE = 96; // a tile move never takes this long
+    static constexpr float REWARD_SCALE = 300.0f; // score that counts as a full win
+    static constexpr float EXPLORATION = 1.0f;
+
+private:
+    struct Node {
+        int32_t parent;
+        int32_t children[4];
+        uint8_t untried;     // bit per Direction still to expand
+        bool terminal;
+        uint32_t visits;
+        float valueSum;
+    };
+
+    struct Worker {
+        std::unique_ptr<Simulation> sim;
+        std::vector<Node> tree;
+        SimRandom rng;
+        uint64_t nodes = 0;
+        uint64_t rollouts = 0;
+        uint64_t simTicks = 0;
+    };
+
+    double budgetMs;
+    uint64_t seed;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<Worker> workers;
+    Stats stats;
+
+    // Path distance from every tile to the nearest pellet left at the
+    // decision root (-1 where none is reachable); read by all workers
+    std::vector<int32_t> pelletDistance;
+
+    void buildPelletDistance(const Maze& maze);
+
+    void search(Worker& worker, const SimState& root, double deadline_seconds) const;
+    int32_t addNode(Worker& worker, int32_t parent, const Simulation& sim) const;
+
+    // Apply dir and run until Pac-Man reaches the next tile (or dies)
+    static void advance(Worker& worker, Simulation& sim, Direction dir);
+    static uint8_t legalMoves(const Simulation& sim);
+
+    // Rollout policy: forward moves that keep clear of dangerous ghosts,
+    // preferring ones that eat a pellet, then ones that close in on one
+    uint8_t rolloutMoves(const Simulation& sim) const;
+    float evaluate(const Simulation& sim, int start_score, int start_lives, int start_distance) const;
+};
+
+#endif // MCTSBOT_H
@@ -1,30 +1,39 @@
 #include "mesh.h"
 #include "../glad/glad.h"
 
-Mesh::Mesh() : vao(0), vbo(0), vertex_count(0) {}
+Mesh::Mesh() : vao(0), vbo(0), instance_vbo(0), vertex_count(0), instance_count(0) {}
 
 Mesh::~Mesh() {
+    if (instance_vbo != 0) glDeleteBuffers(1, &instance_vbo);
     if (vbo != 0) glDeleteBuffers(1, &vbo);
     if (vao != 0) glDeleteVertexArrays(1, &vao);
 }
 
 Mesh::Mesh(Mesh&& other) noexcept 
-    : vao(other.vao), vbo(other.vbo), vertex_count(other.vertex_count) {
+    : vao(other.vao), vbo(other.vbo), instance_vbo(other.instance_vbo)
+    , vertex_count(other.vertex_count), instance_count(other.instance_count) {
     other.vao = 0;
     other.vbo = 0;
+    other.instance_vbo = 0;
     other.vertex_count = 0;
+    other.instance_count = 0;
 }
 
 Mesh& Mesh::operator=(Mesh&& other) noexcept {
     if (this != &other) {
+        if (instance_vbo != 0) glDeleteBuffers(1, &instance_vbo);
         if (vbo != 0) glDeleteBuffers(1, &vbo);
         if (vao != 0) glDeleteVertexArrays(1, &vao);
         vao = other.vao;
         vbo = other.vbo;
+        instance_vbo = other.instance_vbo;
         vertex_count = other.vertex_count;
+        instance_count = other.instance_count;
         other.vao = 0;
         other.vbo = 0;
+        other.instance_vbo = 0;
         other.vertex_count = 0;
+        other.instance_count = 0;
     }
     return *this;
 }
@@ -60,6 +69,36 @@ void Mesh::draw() const {
     glBindVertexArray(0);
 }
 
+void Mesh::setInstances(const std::vector<glm::mat4>& transforms) {
+    instance_count = transforms.size();
+    glBindVertexArray(vao);
+    
+    if (instance_vbo == 0) {
+        glGenBuffers(1, &instance_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+        // A mat4 attribute occupies four consecutive vec4 locations
+        for (unsigned int col = 0; col < 4; ++col) {
+            glEnableVertexAttribArray(4 + col);
+            glVertexAttribPointer(4 + col, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (void*)(col * sizeof(glm::vec4)));
+            glVertexAttribDivisor(4 + col, 1);
+        }
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+    }
+    glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(glm::mat4), transforms.data(), GL_STATIC_DRAW);
+    
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Mesh::drawInstanced() const {
+    if (instance_count == 0) return;
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<int>(vertex_count), static_cast<int>(instance_count));
+    glBindVertexArray(0);
+}
+
 void Mesh::bind() const { glBindVertexArray(vao); }
 void Mesh::unbind() const { glBindVertexArray(0); }
 
@@ -28,6 +28,12 @@ public:
     
     void create(const std::vector<Vertex>& vertices);
     void draw() const;
+    
+    // Per-instance model matrices (vertex attributes 4-7) for drawInstanced()
+    void setInstances(const std::vector<glm::mat4>& transforms);
+    void drawInstanced() const;
+    size_t getInstanceCount() const { return instance_count; }
+
     void bind() const;
     void unbind() const;
     size_t getVertexCount() const { return vertex_count; }
@@ -35,7 +41,9 @@ public:
 private:
     unsigned int vao;
     unsigned int vbo;
+    unsigned int instance_vbo;
     size_t vertex_count;
+    size_t instance_count;
 };
 
 Mesh createCube(const glm::vec3& color);
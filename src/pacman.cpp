@@ -1,6 +1,5 @@
 #include "pacman.h"
 #include "maze.h"
-#include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 
 PacMan::PacMan()
@@ -14,9 +13,10 @@ PacMan::PacMan()
     , mouth_opening(true)
     , powerTime(0.0f)
     , isPowered(false)
+    , logging(true)
     , buffered_dir(Direction::NONE)
-    , spawn_x(14)
-    , spawn_y(6)
+    , spawn_x(SPAWN_X)
+    , spawn_y(SPAWN_Y)
 {
     move_duration = 0.18f;
 }
@@ -31,7 +31,7 @@ void PacMan::update(float delta_time) {
         powerTime -= delta_time;
         if (powerTime <= 0.0f) {
             isPowered = false;
-            std::cout << "Power wore off!" << std::endl;
+            if (logging) std::cout << "Power wore off!" << std::endl;
         }
     }
     
@@ -90,17 +90,17 @@ bool PacMan::collectPellet(Maze& maze) {
     
     if (tile == TileType::PELLET) {
         maze.setTile(grid_x, grid_y, TileType::FLOOR);
-        score += 10;
+        score += PELLET_POINTS;
         pelletsEaten++;
         return false;
     }
     else if (tile == TileType::POWER) {
         maze.setTile(grid_x, grid_y, TileType::FLOOR);
-        score += 50;
+        score += POWER_POINTS;
         pelletsEaten++;
         isPowered = true;
         powerTime = POWER_DURATION;
-        std::cout << "POWER UP! Ghosts are scared!" << std::endl;
+        if (logging) std::cout << "POWER UP! Ghosts are scared!" << std::endl;
         return true;
     }
     return false;
@@ -109,7 +109,7 @@ bool PacMan::collectPellet(Maze& maze) {
 void PacMan::die() {
     lives--;
     isDead = true;
-    std::cout << "Pac-Man died! Lives remaining: " << lives << std::endl;
+    if (logging) std::cout << "Pac-Man died! Lives remaining: " << lives << std::endl;
 }
 
 void PacMan::respawn(const Maze& maze) {
@@ -121,30 +121,31 @@ void PacMan::respawn(const Maze& maze) {
     powerTime = 0.0f;
 }
 
-void PacMan::onTileReached() {
+void PacMan::saveState(PacManState& state) const {
+    Entity::saveState(state.entity);
+    state.score = score;
+    state.pelletsEaten = pelletsEaten;
+    state.lives = lives;
+    state.powerTime = powerTime;
+    state.mouth_angle = mouth_angle;
+    state.isDead = isDead;
+    state.isPowered = isPowered;
+    state.mouth_opening = mouth_opening;
+    state.buffered_dir = static_cast<int8_t>(buffered_dir);
 }
 
-void PacMan::render(Shader& shader) {
-    if (isDead) return;
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, world_pos);
-    
-    float rotation = 0.0f;
-    switch (current_dir) {
-        case Direction::RIGHT: rotation = 0.0f; break;
-        case Direction::UP:    rotation = 90.0f; break;
-        case Direction::LEFT:  rotation = 180.0f; break;
-        case Direction::DOWN:  rotation = 270.0f; break;
-        default: break;
-    }
-    model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 1.0f, 0.0f));
-    model = glm::scale(model, glm::vec3(0.8f));
-    
-    shader.setMat4("model", model);
-    mesh.draw();
+void PacMan::loadState(const PacManState& state) {
+    Entity::loadState(state.entity);
+    score = state.score;
+    pelletsEaten = state.pelletsEaten;
+    lives = state.lives;
+    powerTime = state.powerTime;
+    mouth_angle = state.mouth_angle;
+    isDead = state.isDead;
+    isPowered = state.isPowered;
+    mouth_opening = state.mouth_opening;
+    buffered_dir = static_cast<Direction>(state.buffered_dir);
 }
 
-void PacMan::createMesh() {
-    mesh = createCube(COLOR);
+void PacMan::onTileReached() {
 }
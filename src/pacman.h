@@ -2,8 +2,19 @@
 #define PACMAN_H
 
 #include "entity.h"
-#include "mesh.h"
-#include "shader.h"
+
+struct PacManState {
+    EntityState entity;
+    int32_t score;
+    int32_t pelletsEaten;
+    int32_t lives;
+    float powerTime;
+    float mouth_angle;
+    bool isDead;
+    bool isPowered;
+    bool mouth_opening;
+    int8_t buffered_dir;
+};
 
 class PacMan : public Entity {
 public:
@@ -22,20 +33,28 @@ public:
     float powerTime;
     bool isPowered;
     
+    // Console messages (search clones turn these off)
+    bool logging;
+    
     void update(float delta_time) override;
     void handleInput(Direction input_dir, const class Maze& maze);
     void continueMovement(const class Maze& maze);
     bool collectPellet(class Maze& maze);  // Returns true if power pellet
     void die();
     void respawn(const class Maze& maze);
-    void render(Shader& shader);
-    void createMesh();
+    void setSpawn(int x, int y) { spawn_x = x; spawn_y = y; }
+    
+    void saveState(PacManState& state) const;
+    void loadState(const PacManState& state);
     
     static constexpr glm::vec3 COLOR{1.0f, 1.0f, 0.0f};
     static constexpr float POWER_DURATION = 8.0f;
+    static constexpr int PELLET_POINTS = 10;
+    static constexpr int POWER_POINTS = 50;
+    static constexpr int SPAWN_X = 14;
+    static constexpr int SPAWN_Y = 6;
     
 private:
-    Mesh mesh;
     Direction buffered_dir;
     int spawn_x, spawn_y;
     void onTileReached() override;
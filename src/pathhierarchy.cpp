@@ -0,0 +1,350 @@
+#include "pathhierarchy.h"
+#include "maze.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+
+namespace {
+    const int LOCAL_TILES = PathHierarchy::CLUSTER_SIZE * PathHierarchy::CLUSTER_SIZE;
+
+    // Per-thread A* state over the abstract graph; entries are valid only
+    // where stamp matches the current generation
+    struct SearchScratch {
+        std::vector<int32_t> cost;
+        std::vector<int8_t> first;
+        std::vector<uint32_t> stamp;
+        std::vector<std::pair<int64_t, uint32_t>> heap;   // (key, node), see sortKey
+        uint32_t generation = 0;
+    };
+
+    thread_local SearchScratch scratch;
+
+    // Order by estimated total, then deepest first: on ties A* heads
+    // straight for the goal instead of widening the frontier
+    int64_t sortKey(int32_t estimate, int32_t cost) {
+        return (static_cast<int64_t>(estimate) << 32) - cost;
+    }
+}
+
+PathHierarchy::PathHierarchy()
+    : width(0)
+    , height(0)
+    , clustersX(0)
+    , clustersY(0)
+{}
+
+void PathHierarchy::build(const Maze& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    clustersX = (width + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    clustersY = (height + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    clusters.assign(static_cast<size_t>(clustersX) * clustersY, Cluster());
+    for (int c = 0; c < static_cast<int>(clusters.size()); c++) {
+        buildCluster(maze, c);
+    }
+    for (int c = 0; c < static_cast<int>(clusters.size()); c++) {
+        linkCluster(maze, c);
+    }
+}
+
+void PathHierarchy::clear() {
+    clusters.clear();
+    width = height = clustersX = clustersY = 0;
+}
+
+void PathHierarchy::updateTile(const Maze& maze, int x, int y) {
+    if (!isBuilt() || x < 0 || x >= width || y < 0 || y >= height) return;
+
+    // Border runs depend on the tiles on both sides, so a tile on a
+    // border also changes the cluster across it
+    int rebuilt[5];
+    int count = 0;
+    rebuilt[count++] = getCluster(static_cast<uint32_t>(y * width + x));
+    for (int d = 0; d < 4; d++) {
+        glm::ivec2 offset = Entity::getDirectionOffset(static_cast<Direction>(d));
+        int nx = (x + offset.x + width) % width;
+        int ny = (y + offset.y + height) % height;
+        int cluster = getCluster(static_cast<uint32_t>(ny * width + nx));
+        if (std::find(rebuilt, rebuilt + count, cluster) == rebuilt + count) rebuilt[count++] = cluster;
+    }
+    for (int i = 0; i < count; i++) buildCluster(maze, rebuilt[i]);
+
+    // Entrance numbers changed in the rebuilt clusters, so refresh the
+    // crossings that point into them
+    for (int i = 0; i < count; i++) {
+        int cx = rebuilt[i] % clustersX;
+        int cy = rebuilt[i] / clustersX;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx != 0 && dy != 0) continue;
+                int nx = (cx + dx + clustersX) % clustersX;
+                int ny = (cy + dy + clustersY) % clustersY;
+                linkCluster(maze, ny * clustersX + nx);
+            }
+        }
+    }
+}
+
+int PathHierarchy::getEntranceCount() const {
+    int count = 0;
+    for (const Cluster& cluster : clusters) count += static_cast<int>(cluster.entrances.size());
+    return count;
+}
+
+int PathHierarchy::getCluster(uint32_t tile) const {
+    int x = static_cast<int>(tile % width);
+    int y = static_cast<int>(tile / width);
+    return (y / CLUSTER_SIZE) * clustersX + x / CLUSTER_SIZE;
+}
+
+void PathHierarchy::buildCluster(const Maze& maze, int c) {
+    Cluster& cluster = clusters[c];
+    cluster.entrances.clear();
+
+    int x0 = (c % clustersX) * CLUSTER_SIZE;
+    int y0 = (c / clustersX) * CLUSTER_SIZE;
+    int x1 = std::min(x0 + CLUSTER_SIZE, width) - 1;
+    int y1 = std::min(y0 + CLUSTER_SIZE, height) - 1;
+
+    // Walk each side; both clusters on a border see the same runs, so
+    // their entrances pair up tile for tile
+    for (int d = 0; d < 4; d++) {
+        Direction dir = static_cast<Direction>(d);
+        bool vertical = (dir == Direction::UP || dir == Direction::DOWN);
+        int length = vertical ? x1 - x0 + 1 : y1 - y0 + 1;
+
+        auto borderTile = [&](int k) {
+            switch (dir) {
+                case Direction::UP:   return static_cast<uint32_t>(y1 * width + x0 + k);
+                case Direction::DOWN: return static_cast<uint32_t>(y0 * width + x0 + k);
+                case Direction::LEFT: return static_cast<uint32_t>((y0 + k) * width + x0);
+                default:              return static_cast<uint32_t>((y0 + k) * width + x1);
+            }
+        };
+        auto crosses = [&](uint32_t tile) {
+            int x = static_cast<int>(tile % width);
+            int y = static_cast<int>(tile / width);
+            if (!maze.isWalkable(x, y)) return false;
+            uint32_t next = maze.getNeighbour(tile, dir);
+            return next != Maze::NO_NEIGHBOUR && getCluster(next) != c;
+        };
+
+        int runStart = -1;
+        for (int k = 0; k <= length; k++) {
+            bool open = k < length && crosses(borderTile(k));
+            if (open && runStart < 0) runStart = k;
+            if (open || runStart < 0) continue;
+
+            int runEnd = k - 1;
+            if (runEnd - runStart + 1 < SPLIT_RUN) {
+                addEntrance(cluster, borderTile((runStart + runEnd) / 2), dir);
+            } else {
+                addEntrance(cluster, borderTile(runStart), dir);
+                addEntrance(cluster, borderTile(runEnd), dir);
+            }
+            runStart = -1;
+        }
+    }
+
+    // Path lengths between entrances without leaving the cluster
+    size_t count = cluster.entrances.size();
+    cluster.distances.assign(count * count, -1);
+    int16_t dist[LOCAL_TILES];
+    for (size_t i = 0; i < count; i++) {
+        searchCluster(maze, c, cluster.entrances[i].tile, dist, nullptr);
+        for (size_t j = 0; j < count; j++) {
+            uint32_t tile = cluster.entrances[j].tile;
+            int local = (static_cast<int>(tile / width) - y0) * CLUSTER_SIZE + static_cast<int>(tile % width) - x0;
+            cluster.distances[i * count + j] = dist[local];
+        }
+    }
+}
+
+void PathHierarchy::addEntrance(Cluster& cluster, uint32_t tile, Direction exit) {
+    uint8_t bit = static_cast<uint8_t>(1u << static_cast<int>(exit));
+    for (Entrance& entrance : cluster.entrances) {
+        // Corner tiles can open onto two borders
+        if (entrance.tile == tile) {
+            entrance.exits |= bit;
+            return;
+        }
+    }
+    if (cluster.entrances.size() < static_cast<size_t>(MAX_ENTRANCES)) {
+        cluster.entrances.push_back({tile, bit, {NO_ENTRANCE, NO_ENTRANCE, NO_ENTRANCE, NO_ENTRANCE}});
+    }
+}
+
+void PathHierarchy::linkCluster(const Maze& maze, int c) {
+    for (Entrance& entrance : clusters[c].entrances) {
+        for (int d = 0; d < 4; d++) {
+            entrance.across[d] = NO_ENTRANCE;
+            if (!((entrance.exits >> d) & 1u)) continue;
+            uint32_t next = maze.getNeighbour(entrance.tile, static_cast<Direction>(d));
+            if (next == Maze::NO_NEIGHBOUR) continue;
+            int nextCluster = getCluster(next);
+            int j = findEntrance(nextCluster, next);
+            if (j >= 0) entrance.across[d] = static_cast<uint32_t>(nextCluster * MAX_ENTRANCES + j);
+        }
+    }
+}
+
+int PathHierarchy::findEntrance(int c, uint32_t tile) const {
+    const std::vector<Entrance>& entrances = clusters[c].entrances;
+    for (size_t i = 0; i < entrances.size(); i++) {
+        if (entrances[i].tile == tile) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void PathHierarchy::searchCluster(const Maze& maze, int c, uint32_t start, int16_t* dist, int8_t* first) const {
+    int x0 = (c % clustersX) * CLUSTER_SIZE;
+    int y0 = (c / clustersX) * CLUSTER_SIZE;
+    auto toLocal = [&](uint32_t tile) {
+        return (static_cast<int>(tile / width) - y0) * CLUSTER_SIZE + static_cast<int>(tile % width) - x0;
+    };
+
+    std::fill(dist, dist + LOCAL_TILES, static_cast<int16_t>(-1));
+    if (first) std::fill(first, first + LOCAL_TILES, static_cast<int8_t>(Direction::NONE));
+
+    uint32_t queue[LOCAL_TILES];
+    int head = 0;
+    int tail = 0;
+    int startLocal = toLocal(start);
+    dist[startLocal] = 0;
+    queue[tail++] = start;
+
+    while (head < tail) {
+        uint32_t tile = queue[head++];
+        int local = toLocal(tile);
+        for (int d = 0; d < 4; d++) {
+            uint32_t next = maze.getNeighbour(tile, static_cast<Direction>(d));
+            if (next == Maze::NO_NEIGHBOUR || getCluster(next) != c) continue;
+
+            int nextLocal = toLocal(next);
+            if (dist[nextLocal] >= 0) continue;
+            dist[nextLocal] = static_cast<int16_t>(dist[local] + 1);
+            if (first) first[nextLocal] = (local == startLocal) ? static_cast<int8_t>(d) : first[local];
+            queue[tail++] = next;
+        }
+    }
+}
+
+int PathHierarchy::getDistance(const Maze& maze, int from_x, int from_y, int to_x, int to_y) const {
+    return findRoute(maze, from_x, from_y, to_x, to_y).distance;
+}
+
+Direction PathHierarchy::getNextStep(const Maze& maze, int from_x, int from_y, int to_x, int to_y) const {
+    return findRoute(maze, from_x, from_y, to_x, to_y).first;
+}
+
+PathHierarchy::Route PathHierarchy::findRoute(const Maze& maze, int from_x, int from_y, int to_x, int to_y) const {
+    Route best{-1, Direction::NONE};
+    if (!isBuilt() || from_x < 0 || from_x >= width || from_y < 0 || from_y >= height ||
+        !maze.isWalkable(to_x, to_y)) return best;
+    if (from_x == to_x && from_y == to_y) return Route{0, Direction::NONE};
+
+    uint32_t fromTile = static_cast<uint32_t>(from_y * width + from_x);
+    uint32_t toTile = static_cast<uint32_t>(to_y * width + to_x);
+    int startCluster = getCluster(fromTile);
+    int goalCluster = getCluster(toTile);
+    auto toLocal = [&](int c, uint32_t tile) {
+        return (static_cast<int>(tile / width) - (c / clustersX) * CLUSTER_SIZE) * CLUSTER_SIZE +
+               static_cast<int>(tile % width) - (c % clustersX) * CLUSTER_SIZE;
+    };
+
+    // Refine locally: from the start to its cluster's entrances (and the
+    // goal, if it is in the same cluster), and from the goal's entrances in
+    int16_t startDist[LOCAL_TILES];
+    int8_t startFirst[LOCAL_TILES];
+    searchCluster(maze, startCluster, fromTile, startDist, startFirst);
+    if (startCluster == goalCluster) {
+        int local = toLocal(goalCluster, toTile);
+        if (startDist[local] >= 0) best = Route{startDist[local], static_cast<Direction>(startFirst[local])};
+    }
+
+    int16_t goalDist[LOCAL_TILES];
+    searchCluster(maze, goalCluster, toTile, goalDist, nullptr);
+    const std::vector<Entrance>& goalEntrances = clusters[goalCluster].entrances;
+    int16_t goalCost[MAX_ENTRANCES];
+    for (size_t i = 0; i < goalEntrances.size(); i++) {
+        goalCost[i] = goalDist[toLocal(goalCluster, goalEntrances[i].tile)];
+    }
+
+    // A* over entrances; wrapped Manhattan never overestimates, even
+    // through tunnels
+    size_t nodeCount = clusters.size() * MAX_ENTRANCES;
+    if (scratch.cost.size() < nodeCount) {
+        scratch.cost.resize(nodeCount);
+        scratch.first.resize(nodeCount);
+        scratch.stamp.assign(nodeCount, 0);
+        scratch.generation = 0;
+    }
+    if (++scratch.generation == 0) {
+        std::fill(scratch.stamp.begin(), scratch.stamp.end(), 0u);
+        scratch.generation = 1;
+    }
+    SearchScratch& state = scratch;
+    const uint32_t generation = state.generation;
+    std::vector<std::pair<int64_t, uint32_t>>& heap = state.heap;
+    heap.clear();
+    auto order = std::greater<std::pair<int64_t, uint32_t>>();
+
+    auto estimate = [&](uint32_t tile) {
+        int dx = std::abs(static_cast<int>(tile % width) - to_x);
+        int dy = std::abs(static_cast<int>(tile / width) - to_y);
+        return std::min(dx, width - dx) + std::min(dy, height - dy);
+    };
+    auto relax = [&](uint32_t node, uint32_t tile, int32_t cost, int8_t first) {
+        if (state.stamp[node] == generation && state.cost[node] <= cost) return;
+        state.stamp[node] = generation;
+        state.cost[node] = cost;
+        state.first[node] = first;
+        heap.emplace_back(sortKey(cost + estimate(tile), cost), node);
+        std::push_heap(heap.begin(), heap.end(), order);
+    };
+
+    const std::vector<Entrance>& startEntrances = clusters[startCluster].entrances;
+    for (size_t i = 0; i < startEntrances.size(); i++) {
+        int local = toLocal(startCluster, startEntrances[i].tile);
+        if (startDist[local] < 0) continue;
+        relax(static_cast<uint32_t>(startCluster * MAX_ENTRANCES + i), startEntrances[i].tile,
+              startDist[local], startFirst[local]);
+    }
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), order);
+        std::pair<int64_t, uint32_t> top = heap.back();
+        heap.pop_back();
+        if (best.distance >= 0 && (top.first >> 32) >= best.distance) break;
+
+        uint32_t node = top.second;
+        int c = static_cast<int>(node / MAX_ENTRANCES);
+        int i = static_cast<int>(node % MAX_ENTRANCES);
+        const Cluster& cluster = clusters[c];
+        const Entrance& entrance = cluster.entrances[i];
+        int32_t cost = state.cost[node];
+        int8_t first = state.first[node];
+        if (top.first != sortKey(cost + estimate(entrance.tile), cost)) continue;   // stale
+
+        if (c == goalCluster && goalCost[i] >= 0) {
+            int total = cost + goalCost[i];
+            if (best.distance < 0 || total < best.distance) best = Route{total, static_cast<Direction>(first)};
+        }
+
+        size_t count = cluster.entrances.size();
+        for (size_t j = 0; j < count; j++) {
+            int16_t dist = cluster.distances[i * count + j];
+            if (dist <= 0) continue;
+            relax(static_cast<uint32_t>(c * MAX_ENTRANCES + j), cluster.entrances[j].tile, cost + dist, first);
+        }
+        for (int d = 0; d < 4; d++) {
+            uint32_t across = entrance.across[d];
+            if (across == NO_ENTRANCE) continue;
+            // Leaving straight from the start tile: this crossing is the first step
+            int8_t step = (first == static_cast<int8_t>(Direction::NONE)) ? static_cast<int8_t>(d) : first;
+            relax(across, clusters[across / MAX_ENTRANCES].entrances[across % MAX_ENTRANCES].tile, cost + 1, step);
+        }
+    }
+    return best;
+}
@@ -0,0 +1,95 @@
+#ifndef PATHHIERARCHY_H
+#define PATHHIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+#include "entity.h"
+
+class Maze;
+
+/**
+ * Hierarchical pathfinding (HPA*) for mazes too large for PathTable.
+ *
+ * The maze is cut into CLUSTER_SIZE square clusters. Along each border
+ * between two clusters, every run of open crossings gets one or two
+ * entrances (one tile on each side), and each cluster stores the path
+ * lengths between its own entrances. A query searches locally inside the
+ * start and goal clusters, then runs A* over the entrance graph; the
+ * first step comes from the local search, so only the start cluster is
+ * ever refined to tiles.
+ *
+ * Paths are near-optimal: they pass through entrance tiles, which can
+ * add a few steps over the true shortest path.
+ *
+ * Queries are const and safe to run from several threads at once.
+ */
+class PathHierarchy {
+public:
+    static constexpr int CLUSTER_SIZE = 16;
+    // Runs of open border at least this long get an entrance at each end
+    static constexpr int SPLIT_RUN = 6;
+    // Upper bound on entrances per cluster (fixes the abstract node ids)
+    static constexpr int MAX_ENTRANCES = 4 * CLUSTER_SIZE;
+
+    PathHierarchy();
+
+    // Cut the maze into clusters and build every entrance graph
+    void build(const Maze& maze);
+    void clear();
+    bool isBuilt() const { return !clusters.empty(); }
+
+    // Tile (x, y) changed walkability: rebuild its cluster and any
+    // cluster across a border it sits on. The maze links must already be
+    // up to date.
+    void updateTile(const Maze& maze, int x, int y);
+
+    // Path length between two tiles (-1 if unreachable)
+    int getDistance(const Maze& maze, int from_x, int from_y, int to_x, int to_y) const;
+
+    // First step from one tile toward another (NONE if unreachable or equal)
+    Direction getNextStep(const Maze& maze, int from_x, int from_y, int to_x, int to_y) const;
+
+    int getClusterCount() const { return static_cast<int>(clusters.size()); }
+    int getEntranceCount() const;
+
+private:
+    static constexpr uint32_t NO_ENTRANCE = 0xFFFFFFFFu;
+
+    struct Entrance {
+        uint32_t tile;
+        uint8_t exits;      // bit per Direction that crosses into another cluster
+        uint32_t across[4]; // node on the far side per Direction (cluster * MAX_ENTRANCES + index)
+    };
+
+    struct Cluster {
+        std::vector<Entrance> entrances;
+        std::vector<int16_t> distances;   // [from * count + to], -1 if not connected inside
+    };
+
+    struct Route {
+        int distance;
+        Direction first;
+    };
+
+    int width;
+    int height;
+    int clustersX;
+    int clustersY;
+    std::vector<Cluster> clusters;
+
+    int getCluster(uint32_t tile) const;
+    void buildCluster(const Maze& maze, int cluster);
+    void addEntrance(Cluster& cluster, uint32_t tile, Direction exit);
+    int findEntrance(int cluster, uint32_t tile) const;
+
+    // Resolve the across links of a cluster's entrances
+    void linkCluster(const Maze& maze, int cluster);
+
+    // BFS from start that stays inside the cluster. dist/first are indexed
+    // by local tile (CLUSTER_SIZE * CLUSTER_SIZE); first may be nullptr.
+    void searchCluster(const Maze& maze, int cluster, uint32_t start, int16_t* dist, int8_t* first) const;
+
+    Route findRoute(const Maze& maze, int from_x, int from_y, int to_x, int to_y) const;
+};
+
+#endif // PATHHIERARCHY_H
@@ -0,0 +1,231 @@
+#include "pathtable.h"
+#include "maze.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace {
+    const uint32_t TABLE_MAGIC = 0x54504D50; // "PMPT"
+    const uint32_t TABLE_VERSION = 2;
+
+    struct TableHeader {
+        uint32_t magic;
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        int32_t nodeCount;
+        uint32_t reserved;
+        uint64_t layoutHash;
+    };
+
+    const Direction SEARCH_ORDER[] = {Direction::UP, Direction::LEFT, Direction::DOWN, Direction::RIGHT};
+}
+
+PathTable::PathTable()
+    : width(0)
+    , height(0)
+    , nodeCount(0)
+    , layoutHash(0)
+{}
+
+uint64_t PathTable::hashLayout(const Maze& maze) {
+    // 64-bit FNV-1a over the walkable mask; pellets don't affect paths
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int y = 0; y < maze.getHeight(); y++) {
+        for (int x = 0; x < maze.getWidth(); x++) {
+            hash ^= maze.isWalkable(x, y) ? 1u : 0u;
+            hash *= 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+void PathTable::indexTiles(const Maze& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    nodeCount = 0;
+    tileIndex.assign(width * height, -1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (maze.isWalkable(x, y)) {
+                tileIndex[y * width + x] = nodeCount++;
+            }
+        }
+    }
+    layoutHash = hashLayout(maze);
+}
+
+bool PathTable::build(const Maze& maze, unsigned int threads) {
+    indexTiles(maze);
+    if (nodeCount == 0) return false;
+    if (nodeCount > MAX_NODES) {
+        std::cout << "Path table skipped: " << nodeCount << " walkable tiles (hierarchical paths instead)" << std::endl;
+        nodeCount = 0;
+        return false;
+    }
+
+    size_t entries = static_cast<size_t>(nodeCount) * nodeCount;
+    distances.assign(entries, UNREACHABLE);
+    nextSteps.assign(entries, 0);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<unsigned int>(threads, nodeCount);
+
+    // Rows are independent, so workers pull small batches of targets
+    const int BATCH = 16;
+    std::atomic<int> nextRow(0);
+    auto worker = [&]() {
+        for (;;) {
+            int first = nextRow.fetch_add(BATCH);
+            if (first >= nodeCount) break;
+            buildRows(maze, first, std::min(first + BATCH, nodeCount));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) thread.join();
+    return true;
+}
+
+void PathTable::buildRows(const Maze& maze, int first, int last) {
+    std::vector<int> queue;
+    queue.reserve(nodeCount);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int target = tileIndex[y * width + x];
+            if (target < first || target >= last) continue;
+
+            // BFS outward from the target; each tile steps back toward
+            // the neighbour it was discovered from
+            uint16_t* dist = &distances[static_cast<size_t>(target) * nodeCount];
+            uint8_t* step = &nextSteps[static_cast<size_t>(target) * nodeCount];
+
+            queue.clear();
+            queue.push_back(y * width + x);
+            dist[target] = 0;
+
+            for (size_t head = 0; head < queue.size(); ++head) {
+                int tile = queue[head];
+                uint16_t nextDist = dist[tileIndex[tile]] + 1;
+
+                for (Direction dir : SEARCH_ORDER) {
+                    uint32_t link = maze.getNeighbour(static_cast<uint32_t>(tile), dir);
+                    if (link == Maze::NO_NEIGHBOUR) continue;
+
+                    int node = tileIndex[link];
+                    if (dist[node] != UNREACHABLE) continue;
+
+                    dist[node] = nextDist;
+                    step[node] = static_cast<uint8_t>(static_cast<int>(Entity::getOppositeDirection(dir)) + 1);
+                    queue.push_back(static_cast<int>(link));
+                }
+            }
+        }
+    }
+}
+
+bool PathTable::save(const std::string& path) const {
+    if (nodeCount == 0) return false;
+
+    TableHeader header{TABLE_MAGIC, TABLE_VERSION, width, height, nodeCount, 0, layoutHash};
+
+    // Write to a temporary file first so a crash never leaves a torn cache
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "ERROR::PATHTABLE: Could not write " << tmpPath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(distances.data()), distances.size() * sizeof(uint16_t));
+        file.write(reinterpret_cast<const char*>(nextSteps.data()), nextSteps.size());
+        if (!file) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool PathTable::load(const std::string& path, const Maze& maze) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    indexTiles(maze);
+
+    TableHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != TABLE_MAGIC || header.version != TABLE_VERSION ||
+        header.width != width || header.height != height ||
+        header.nodeCount != nodeCount || header.layoutHash != layoutHash) {
+        nodeCount = 0;
+        return false;
+    }
+
+    size_t entries = static_cast<size_t>(nodeCount) * nodeCount;
+    distances.resize(entries);
+    nextSteps.resize(entries);
+    file.read(reinterpret_cast<char*>(distances.data()), entries * sizeof(uint16_t));
+    file.read(reinterpret_cast<char*>(nextSteps.data()), entries);
+    if (!file) {
+        nodeCount = 0;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const PathTable> PathTable::loadOrBuild(const Maze& maze, const std::string& cache_path) {
+    auto table = std::make_shared<PathTable>();
+    if (table->load(cache_path, maze)) {
+        std::cout << "Path table loaded: " << table->getNodeCount() << " tiles" << std::endl;
+        return table;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!table->build(maze)) return nullptr;
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "Path table built: " << table->getNodeCount() << " tiles in "
+              << elapsed.count() << " ms" << std::endl;
+
+    if (!table->save(cache_path)) {
+        std::cerr << "ERROR::PATHTABLE: Could not cache " << cache_path << std::endl;
+    }
+    return table;
+}
+
+int PathTable::getIndex(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height || nodeCount == 0) return -1;
+    return tileIndex[y * width + x];
+}
+
+int PathTable::getDistance(int from_x, int from_y, int to_x, int to_y) const {
+    int from = getIndex(from_x, from_y);
+    int to = getIndex(to_x, to_y);
+    if (from < 0 || to < 0) return -1;
+
+    uint16_t dist = distances[static_cast<size_t>(to) * nodeCount + from];
+    return dist == UNREACHABLE ? -1 : dist;
+}
+
+Direction PathTable::getNextStep(int from_x, int from_y, int to_x, int to_y) const {
+    int from = getIndex(from_x, from_y);
+    int to = getIndex(to_x, to_y);
+    if (from < 0 || to < 0) return Direction::NONE;
+
+    return static_cast<Direction>(nextSteps[static_cast<size_t>(to) * nodeCount + from] - 1);
+}
@@ -0,0 +1,65 @@
+#ifndef PATHTABLE_H
+#define PATHTABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "entity.h"
+
+class Maze;
+
+/**
+ * All-pairs shortest paths over the walkable tiles of a maze.
+ *
+ * Walkable tiles are numbered densely; for every (from, to) pair the table
+ * stores the path length (16-bit) and the first step to take. The walkable
+ * layout never changes after Maze::load, so the table is built once per
+ * level and can be cached to disk beside the level file.
+ */
+class PathTable {
+public:
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+    // Tables grow with the square of this; larger mazes use PathHierarchy
+    static constexpr int MAX_NODES = 4096;
+
+    PathTable();
+
+    // Build the tables with one BFS per walkable tile (0 threads = all cores)
+    bool build(const Maze& maze, unsigned int threads = 0);
+
+    // Load tables written by save(); fails if they don't match this maze
+    bool load(const std::string& path, const Maze& maze);
+    bool save(const std::string& path) const;
+
+    // Load from cache_path if valid, otherwise build and write the cache
+    static std::shared_ptr<const PathTable> loadOrBuild(const Maze& maze, const std::string& cache_path);
+
+    // Dense index of a walkable tile (-1 if not walkable)
+    int getIndex(int x, int y) const;
+
+    // Path length between two tiles (-1 if either is off the graph or unreachable)
+    int getDistance(int from_x, int from_y, int to_x, int to_y) const;
+
+    // First step from one tile toward another (NONE if unreachable or equal)
+    Direction getNextStep(int from_x, int from_y, int to_x, int to_y) const;
+
+    int getNodeCount() const { return nodeCount; }
+
+private:
+    int width;
+    int height;
+    int nodeCount;
+    uint64_t layoutHash;
+
+    std::vector<int32_t> tileIndex;      // width * height, -1 for non-walkable
+    std::vector<uint16_t> distances;     // [to * nodeCount + from]
+    std::vector<uint8_t> nextSteps;      // [to * nodeCount + from], Direction + 1
+
+    void indexTiles(const Maze& maze);
+    void buildRows(const Maze& maze, int first, int last);
+    static uint64_t hashLayout(const Maze& maze);
+};
+
+#endif // PATHTABLE_H
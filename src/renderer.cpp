@@ -1,7 +1,46 @@
 #include "renderer.h"
+#include <algorithm>
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 
+namespace {
+    // Pellet and power pellet cube placement, shared by both renderers
+    glm::mat4 pelletTransform(const glm::vec3& tile_pos) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), tile_pos + glm::vec3(0.0f, 0.2f, 0.0f));
+        return glm::scale(model, glm::vec3(0.15f));
+    }
+    
+    glm::mat4 powerTransform(const glm::vec3& tile_pos) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), tile_pos + glm::vec3(0.0f, 0.3f, 0.0f));
+        return glm::scale(model, glm::vec3(0.35f));
+    }
+    
+    // Set up the instanced program for one batch; nullptr if it is missing
+    Shader* beginBatch(ShaderVariants& shaders, const Camera& camera, const Texture* texture, bool textures_loaded,
+                       uint32_t extra_features = 0) {
+        bool textured = textures_loaded && texture && texture->getID() != 0;
+        Shader* shader = shaders.get(SHADER_INSTANCED | extra_features | (textured ? SHADER_TEXTURED : SHADER_VERTEX_COLOR));
+        if (!shader) return nullptr;
+        
+        shader->use();
+        shader->setMat4("view", camera.getViewMatrix());
+        shader->setMat4("projection", camera.getProjectionMatrix());
+        shader->setVec3("colorTint", glm::vec3(1.0f));
+        
+        if (textured) {
+            texture->bind(0);
+            shader->setInt("textureSampler", 0);
+        }
+        return shader;
+    }
+    
+    void endBatch(const Texture* texture, bool textures_loaded) {
+        if (textures_loaded && texture && texture->getID() != 0) {
+            texture->unbind();
+        }
+    }
+}
+
 MazeRenderer::MazeRenderer() : mazeRef(nullptr) {}
 
 void MazeRenderer::loadTextures() {
@@ -18,87 +57,54 @@ void MazeRenderer::loadTextures() {
 }
 
 void MazeRenderer::buildFromMaze(const Maze& maze) {
+    std::vector<glm::mat4> walls;
+    std::vector<glm::mat4> floors;
+    LevelManager::buildGeometry(maze, walls, floors);
+    buildFromGeometry(maze, walls, floors);
+}
+
+void MazeRenderer::buildFromGeometry(const Maze& maze, const std::vector<glm::mat4>& walls,
+                                     const std::vector<glm::mat4>& floors) {
     mazeRef = &maze;
-    wallPositions.clear();
-    floorPositions.clear();
-    
-    // Use textured meshes
-    wallMesh = std::make_unique<Mesh>(createTexturedCube(WALL_COLOR));
-    floorMesh = std::make_unique<Mesh>(createTexturedFloorTile(FLOOR_COLOR));
-    pelletMesh = std::make_unique<Mesh>(createCube(PELLET_COLOR));
-    powerMesh = std::make_unique<Mesh>(createCube(POWER_COLOR));
     
-    for (int y = 0; y < maze.getHeight(); ++y) {
-        for (int x = 0; x < maze.getWidth(); ++x) {
-            glm::vec3 worldPos = maze.gridToWorld(x, y);
-            TileType tile = maze.getTile(x, y);
-            
-            switch (tile) {
-                case TileType::WALL:
-                    wallPositions.push_back(worldPos + glm::vec3(0.0f, 0.5f, 0.0f));
-                    break;
-                case TileType::FLOOR:
-                case TileType::PELLET:
-                case TileType::POWER:
-                case TileType::DOOR:
-                    floorPositions.push_back(worldPos);
-                    break;
-                case TileType::EMPTY:
-                default:
-                    break;
-            }
-        }
+    // Use textured meshes; kept across levels, only the instances change
+    if (!wallMesh) {
+        wallMesh = std::make_unique<Mesh>(createTexturedCube(WALL_COLOR));
+        floorMesh = std::make_unique<Mesh>(createTexturedFloorTile(FLOOR_COLOR));
+        pelletMesh = std::make_unique<Mesh>(createCube(PELLET_COLOR));
+        powerMesh = std::make_unique<Mesh>(createCube(POWER_COLOR));
     }
     
-    std::cout << "Built maze: " << wallPositions.size() << " walls, " 
-              << floorPositions.size() << " floors" << std::endl;
+    // Static geometry is drawn instanced: one draw call per mesh
+    wallMesh->setInstances(walls);
+    floorMesh->setInstances(floors);
+    
+    std::cout << "Built maze: " << walls.size() << " walls, " 
+              << floors.size() << " floors" << std::endl;
 }
 
-void MazeRenderer::render(Shader& shader, const Camera& camera) {
-    shader.setMat4("view", camera.getViewMatrix());
-    shader.setMat4("projection", camera.getProjectionMatrix());
-    
+void MazeRenderer::renderBatch(ShaderVariants& shaders, const Camera& camera, const Mesh& mesh, const Texture& texture) {
+    if (!beginBatch(shaders, camera, &texture, texturesLoaded)) return;
+    mesh.drawInstanced();
+    endBatch(&texture, texturesLoaded);
+}
+
+void MazeRenderer::render(ShaderVariants& shaders, const Camera& camera) {
     // Render walls with texture
-    if (texturesLoaded && wallTexture.getID() != 0) {
-        shader.setBool("useTexture", true);
-        wallTexture.bind(0);
-        shader.setInt("textureSampler", 0);
-    } else {
-        shader.setBool("useTexture", false);
-    }
-    
-    for (const auto& pos : wallPositions) {
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
-        shader.setMat4("model", model);
-        wallMesh->draw();
-    }
-    
-    // Unbind wall texture
-    wallTexture.unbind();
+    renderBatch(shaders, camera, *wallMesh, wallTexture);
     
     // Render floors with texture
-    if (texturesLoaded && floorTexture.getID() != 0) {
-        shader.setBool("useTexture", true);
-        floorTexture.bind(0);
-        shader.setInt("textureSampler", 0);
-    } else {
-        shader.setBool("useTexture", false);
-    }
-    
-    for (const auto& pos : floorPositions) {
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
-        shader.setMat4("model", model);
-        floorMesh->draw();
-    }
-    
-    // Unbind floor texture
-    floorTexture.unbind();
-    // Reset texture state
-    shader.setBool("useTexture", false);
+    renderBatch(shaders, camera, *floorMesh, floorTexture);
 }
 
-void MazeRenderer::renderPellets(Shader& shader, const Maze& maze) {
-    shader.setBool("useTexture", false);
+void MazeRenderer::renderPellets(ShaderVariants& shaders, const Camera& camera, const Maze& maze) {
+    Shader* shader = shaders.get(SHADER_VERTEX_COLOR);
+    if (!shader) return;
+    
+    shader->use();
+    shader->setMat4("view", camera.getViewMatrix());
+    shader->setMat4("projection", camera.getProjectionMatrix());
+    shader->setVec3("colorTint", glm::vec3(1.0f));
     
     for (int y = 0; y < maze.getHeight(); ++y) {
         for (int x = 0; x < maze.getWidth(); ++x) {
@@ -106,17 +112,102 @@ void MazeRenderer::renderPellets(Shader& shader, const Maze& maze) {
             glm::vec3 worldPos = maze.gridToWorld(x, y);
             
             if (tile == TileType::PELLET) {
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), worldPos + glm::vec3(0.0f, 0.2f, 0.0f));
-                model = glm::scale(model, glm::vec3(0.15f));
-                shader.setMat4("model", model);
+                shader->setMat4("model", pelletTransform(worldPos));
                 pelletMesh->draw();
             }
             else if (tile == TileType::POWER) {
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), worldPos + glm::vec3(0.0f, 0.3f, 0.0f));
-                model = glm::scale(model, glm::vec3(0.35f));
-                shader.setMat4("model", model);
+                shader->setMat4("model", powerTransform(worldPos));
                 powerMesh->draw();
             }
         }
     }
 }
+
+ChunkRenderer::ChunkRenderer() {}
+
+void ChunkRenderer::loadTextures() {
+    wallTexture.load("assets/sprites/pacman-sprite-wall-1766447227855.png");
+    floorTexture.load("assets/sprites/pacman-sprite-ground-1766445952654.png");
+    texturesLoaded = true;
+}
+
+void ChunkRenderer::sync(ChunkWorld& world) {
+    // Evicted chunks
+    for (auto it = gpuChunks.begin(); it != gpuChunks.end();) {
+        if (world.getChunk(it->second->coord)) ++it;
+        else it = gpuChunks.erase(it);
+    }
+    
+    for (const auto& entry : world.getChunks()) {
+        ChunkWorld::Chunk& chunk = *entry.second;
+        auto found = gpuChunks.find(entry.first);
+        if (found == gpuChunks.end()) {
+            if (chunk.meshTaken) continue;
+            auto gpu = std::make_unique<GpuChunk>();
+            gpu->coord = chunk.coord;
+            gpu->walls = createTexturedCube(MazeRenderer::WALL_COLOR);
+            gpu->floors = createTexturedFloorTile(MazeRenderer::FLOOR_COLOR);
+            gpu->pellets = createCube(MazeRenderer::PELLET_COLOR);
+            gpu->powers = createCube(MazeRenderer::POWER_COLOR);
+            gpu->walls.setInstances(chunk.mesh.walls);
+            gpu->floors.setInstances(chunk.mesh.floors);
+            
+            // The GPU copy is the only one needed from here on
+            chunk.mesh = ChunkWorld::MeshData();
+            chunk.meshTaken = true;
+            
+            fillPellets(*gpu, chunk);
+            gpuChunks.emplace(entry.first, std::move(gpu));
+        } else if (found->second->pelletVersion != chunk.pelletVersion) {
+            fillPellets(*found->second, chunk);
+        }
+    }
+}
+
+void ChunkRenderer::fillPellets(GpuChunk& gpu, const ChunkWorld::Chunk& chunk) {
+    const int originX = chunk.coord.x * ChunkWorld::CHUNK_WIDTH;
+    const int originY = chunk.coord.y * ChunkWorld::CHUNK_HEIGHT;
+    
+    transforms.clear();
+    for (int y = 0; y < ChunkWorld::CHUNK_HEIGHT; ++y) {
+        uint32_t bits = chunk.pellets[y];
+        for (int x = 0; bits; ++x, bits >>= 1) {
+            if (bits & 1u) transforms.push_back(pelletTransform(ChunkWorld::tileToWorld(originX + x, originY + y)));
+        }
+    }
+    gpu.pellets.setInstances(transforms);
+    
+    transforms.clear();
+    for (int y = 0; y < ChunkWorld::CHUNK_HEIGHT; ++y) {
+        uint32_t bits = chunk.powers[y];
+        for (int x = 0; bits; ++x, bits >>= 1) {
+            if (bits & 1u) transforms.push_back(powerTransform(ChunkWorld::tileToWorld(originX + x, originY + y)));
+        }
+    }
+    gpu.powers.setInstances(transforms);
+    gpu.pelletVersion = chunk.pelletVersion;
+}
+
+void ChunkRenderer::renderLayer(ShaderVariants& shaders, const Camera& camera, Mesh GpuChunk::*layer,
+                                const Texture* texture) {
+    uint32_t features = 0;
+    if (fog) features |= SHADER_FOG;
+    Shader* shader = beginBatch(shaders, camera, texture, texturesLoaded, features);
+    if (!shader) return;
+    if (fog) {
+        shader->setVec3("fogColor", fogColor);
+        shader->setFloat("fogStart", FOG_END * 0.5f);
+        shader->setFloat("fogEnd", FOG_END);
+    }
+    for (const auto& entry : gpuChunks) {
+        ((*entry.second).*layer).drawInstanced();
+    }
+    endBatch(texture, texturesLoaded);
+}
+
+void ChunkRenderer::render(ShaderVariants& shaders, const Camera& camera) {
+    renderLayer(shaders, camera, &GpuChunk::walls, &wallTexture);
+    renderLayer(shaders, camera, &GpuChunk::floors, &floorTexture);
+    renderLayer(shaders, camera, &GpuChunk::pellets, nullptr);
+    renderLayer(shaders, camera, &GpuChunk::powers, nullptr);
+}
@@ -1,21 +1,28 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "chunkworld.h"
+#include "levelmanager.h"
 #include "maze.h"
 #include "mesh.h"
-#include "shader.h"
+#include "shadervariants.h"
 #include "camera.h"
 #include "texture.h"
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 class MazeRenderer {
 public:
     MazeRenderer();
     
     void buildFromMaze(const Maze& maze);
+    // Upload instance transforms built elsewhere (LevelManager::prepare)
+    void buildFromGeometry(const Maze& maze, const std::vector<glm::mat4>& walls,
+                           const std::vector<glm::mat4>& floors);
     void loadTextures();
-    void render(Shader& shader, const Camera& camera);
-    void renderPellets(Shader& shader, const Maze& maze);
+    void render(ShaderVariants& shaders, const Camera& camera);
+    void renderPellets(ShaderVariants& shaders, const Camera& camera, const Maze& maze);
     
 private:
     std::unique_ptr<Mesh> wallMesh;
@@ -28,15 +35,64 @@ private:
     Texture cornerTexture;
     bool texturesLoaded = false;
     
-    std::vector<glm::vec3> wallPositions;
-    std::vector<glm::vec3> floorPositions;
+    // Draws one instanced batch with the textured or vertex-colour variant
+    void renderBatch(ShaderVariants& shaders, const Camera& camera, const Mesh& mesh, const Texture& texture);
     
     const Maze* mazeRef;
     
+    friend class ChunkRenderer;     // same palette
     static constexpr glm::vec3 WALL_COLOR{1.0f, 1.0f, 1.0f};
     static constexpr glm::vec3 FLOOR_COLOR{1.0f, 1.0f, 1.0f};
     static constexpr glm::vec3 PELLET_COLOR{1.0f, 0.9f, 0.2f};  // Yellow
     static constexpr glm::vec3 POWER_COLOR{1.0f, 0.85f, 0.0f};  // Bright yellow
 };
 
+/**
+ * Draws a ChunkWorld. Each resident chunk gets its own instanced wall,
+ * floor and pellet meshes: walls and floors are uploaded once from the
+ * transforms the chunk's job built, pellet buffers are refilled only when
+ * that chunk's pellets change, and meshes of evicted chunks are freed.
+ */
+class ChunkRenderer {
+public:
+    ChunkRenderer();
+    
+    void loadTextures();
+    
+    // Upload new chunks, refresh changed pellet buffers, free evicted ones
+    void sync(ChunkWorld& world);
+    void render(ShaderVariants& shaders, const Camera& camera);
+    
+    // Fade chunks into color before the edge of the loaded area, so new
+    // chunks never pop in where they can be seen
+    void setFog(const glm::vec3& color) { fog = true; fogColor = color; }
+    
+    size_t getChunkCount() const { return gpuChunks.size(); }
+    
+    // Chunks are resident this far out from Pac-Man in every direction
+    static constexpr float FOG_END = ChunkWorld::LOAD_RADIUS * ChunkWorld::CHUNK_HEIGHT * Maze::TILE_SIZE;
+    
+private:
+    struct GpuChunk {
+        glm::ivec2 coord;
+        Mesh walls;
+        Mesh floors;
+        Mesh pellets;
+        Mesh powers;
+        unsigned int pelletVersion;
+    };
+    
+    std::unordered_map<uint64_t, std::unique_ptr<GpuChunk>> gpuChunks;
+    std::vector<glm::mat4> transforms;
+    
+    Texture wallTexture;
+    Texture floorTexture;
+    bool texturesLoaded = false;
+    bool fog = false;
+    glm::vec3 fogColor{0.0f};
+    
+    void fillPellets(GpuChunk& gpu, const ChunkWorld::Chunk& chunk);
+    void renderLayer(ShaderVariants& shaders, const Camera& camera, Mesh GpuChunk::*layer, const Texture* texture);
+};
+
 #endif // RENDERER_H
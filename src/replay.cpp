@@ -0,0 +1,207 @@
+#include "replay.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    const uint32_t REPLAY_MAGIC = 0x50524D50; // "PMRP"
+    const uint32_t REPLAY_VERSION = 1;
+
+    struct ReplayHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t seed;
+        uint64_t levelHash;
+        uint64_t totalTicks;
+        uint64_t finalChecksum;
+        uint32_t tickRate;
+        uint32_t inputCount;
+    };
+
+    void writeVarint(std::vector<unsigned char>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool readVarint(const std::vector<unsigned char>& in, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            unsigned char byte = in[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+void ReplayLog::begin(uint64_t game_seed, uint64_t level_hash, uint32_t tick_rate) {
+    seed = game_seed;
+    levelHash = level_hash;
+    tickRate = tick_rate;
+    totalTicks = 0;
+    finalChecksum = 0;
+    inputs.clear();
+}
+
+void ReplayLog::record(uint64_t tick, Direction dir) {
+    if (dir == Direction::NONE) return;
+    inputs.push_back({tick, dir});
+}
+
+void ReplayLog::finish(const Simulation& sim) {
+    totalTicks = sim.getTick();
+    finalChecksum = sim.checksum();
+}
+
+bool ReplayLog::save(const std::string& path) const {
+    std::vector<unsigned char> body;
+    body.reserve(inputs.size() * 2);
+    uint64_t lastTick = 0;
+    for (const ReplayInput& input : inputs) {
+        writeVarint(body, ((input.tick - lastTick) << 2) | static_cast<uint64_t>(input.dir));
+        lastTick = input.tick;
+    }
+
+    ReplayHeader header{REPLAY_MAGIC, REPLAY_VERSION, seed, levelHash, totalTicks, finalChecksum,
+                        tickRate, static_cast<uint32_t>(inputs.size())};
+
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::REPLAY: Could not write " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(body.data()), body.size());
+    return static_cast<bool>(file);
+}
+
+bool ReplayLog::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::REPLAY: Could not open " << path << std::endl;
+        return false;
+    }
+
+    ReplayHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION || header.tickRate == 0) {
+        std::cerr << "ERROR::REPLAY: " << path << " is not a replay file" << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> body((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    inputs.clear();
+    inputs.reserve(header.inputCount);
+    size_t pos = 0;
+    uint64_t tick = 0;
+    for (uint32_t i = 0; i < header.inputCount; i++) {
+        uint64_t packed = 0;
+        if (!readVarint(body, pos, packed)) {
+            std::cerr << "ERROR::REPLAY: " << path << " is truncated" << std::endl;
+            return false;
+        }
+        tick += packed >> 2;
+        inputs.push_back({tick, static_cast<Direction>(packed & 3)});
+    }
+
+    seed = header.seed;
+    levelHash = header.levelHash;
+    tickRate = header.tickRate;
+    totalTicks = header.totalTicks;
+    finalChecksum = header.finalChecksum;
+    return true;
+}
+
+uint64_t ReplayLog::hashLevel(const std::string& level_path) {
+    std::ifstream file(level_path, std::ios::binary);
+    uint64_t hash = 0xCBF29CE484222325ull;
+    char c;
+    while (file.get(c)) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool ReplayPlayer::start(const ReplayLog& replay_log, const std::string& level_path) {
+    if (ReplayLog::hashLevel(level_path) != replay_log.levelHash) {
+        std::cerr << "ERROR::REPLAY: Recording was made on a different version of " << level_path << std::endl;
+        return false;
+    }
+
+    log = replay_log;
+    if (!sim.init(level_path)) return false;
+    sim.setSeed(log.seed);
+    sim.newGame();
+
+    cursor = 0;
+    snapshots.clear();
+    takeSnapshot();
+    return true;
+}
+
+void ReplayPlayer::takeSnapshot() {
+    snapshots.emplace_back(sim.getTick(), SimState());
+    sim.saveState(snapshots.back().second);
+}
+
+bool ReplayPlayer::step() {
+    if (isFinished()) return false;
+
+    uint64_t tick = sim.getTick();
+    Direction input = Direction::NONE;
+    while (cursor < log.inputs.size() && log.inputs[cursor].tick <= tick) {
+        input = log.inputs[cursor].dir;
+        cursor++;
+    }
+
+    sim.step(1.0f / static_cast<float>(log.tickRate), input);
+
+    tick = sim.getTick();
+    if (tick % SNAPSHOT_INTERVAL == 0 && tick > snapshots.back().first) {
+        takeSnapshot();
+    }
+    return true;
+}
+
+uint64_t ReplayPlayer::advance(uint64_t ticks) {
+    uint64_t count = 0;
+    while (count < ticks && step()) count++;
+    sim.events.clear();
+    return count;
+}
+
+bool ReplayPlayer::seek(uint64_t target_tick) {
+    if (target_tick > log.totalTicks || snapshots.empty()) return false;
+
+    // Restore the latest snapshot at or before the target (or stay put if
+    // we are already between it and the target), then simulate forward
+    auto it = std::upper_bound(snapshots.begin(), snapshots.end(), target_tick,
+                               [](uint64_t tick, const std::pair<uint64_t, SimState>& snap) {
+                                   return tick < snap.first;
+                               });
+    const auto& snapshot = *(it - 1);
+    if (sim.getTick() > target_tick || sim.getTick() < snapshot.first) {
+        sim.loadState(snapshot.second);
+        cursor = std::lower_bound(log.inputs.begin(), log.inputs.end(), snapshot.first,
+                                  [](const ReplayInput& input, uint64_t tick) {
+                                      return input.tick < tick;
+                                  }) - log.inputs.begin();
+    }
+
+    while (sim.getTick() < target_tick) step();
+    sim.events.clear();
+    return true;
+}
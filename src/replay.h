@@ -0,0 +1,89 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "simstate.h"
+#include "simulation.h"
+
+/**
+ * One player input, applied by the step that starts at this tick.
+ */
+struct ReplayInput {
+    uint64_t tick;
+    Direction dir;
+};
+
+/**
+ * Everything needed to reproduce one game: seed, level identity and the
+ * tick-stamped inputs. On disk the inputs are varints of
+ * (tick delta << 2 | direction), so a typical game is a few KB.
+ */
+class ReplayLog {
+public:
+    uint64_t seed = 0;
+    uint64_t levelHash = 0;
+    uint32_t tickRate = 120;
+    uint64_t totalTicks = 0;
+    uint64_t finalChecksum = 0;
+    std::vector<ReplayInput> inputs;
+
+    // Start a new recording
+    void begin(uint64_t game_seed, uint64_t level_hash, uint32_t tick_rate);
+
+    // Append an input (NONE is ignored); ticks must not decrease
+    void record(uint64_t tick, Direction dir);
+
+    // Close the recording with the final state
+    void finish(const Simulation& sim);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // FNV-1a of the level file's bytes
+    static uint64_t hashLevel(const std::string& level_path);
+};
+
+/**
+ * Plays a ReplayLog back through a private Simulation. Snapshots are taken
+ * every SNAPSHOT_INTERVAL ticks so seek() only re-simulates a short span.
+ */
+class ReplayPlayer {
+public:
+    static constexpr uint64_t SNAPSHOT_INTERVAL = 600;
+
+    // Load the level, check its hash and rewind to tick 0
+    bool start(const ReplayLog& replay_log, const std::string& level_path);
+
+    // Advance one tick; returns false once the recording has ended.
+    // Events accumulate in the simulation until the caller clears them.
+    bool step();
+
+    // Advance up to ticks steps, dropping their events; returns how many ran
+    uint64_t advance(uint64_t ticks);
+
+    // Jump to any tick within the recording (events are dropped)
+    bool seek(uint64_t target_tick);
+
+    bool isFinished() const { return sim.getTick() >= log.totalTicks; }
+
+    // At the end: does the state match what was recorded?
+    bool verify() const { return isFinished() && sim.checksum() == log.finalChecksum; }
+
+    uint64_t getTick() const { return sim.getTick(); }
+    const ReplayLog& getLog() const { return log; }
+    Simulation& getSimulation() { return sim; }
+    const Simulation& getSimulation() const { return sim; }
+
+private:
+    ReplayLog log;
+    Simulation sim;
+    size_t cursor = 0;
+    std::vector<std::pair<uint64_t, SimState>> snapshots;
+
+    void takeSnapshot();
+};
+
+#endif // REPLAY_H
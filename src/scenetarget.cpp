@@ -0,0 +1,174 @@
+#include "scenetarget.h"
+#include "../glad/glad.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SceneTarget::SceneTarget()
+    : fbo(0)
+    , colorRbo(0)
+    , depthRbo(0)
+    , width(0)
+    , height(0)
+    , scale(1.0f)
+    , minScale(0.5f)
+    , maxScale(1.0f)
+    , budgetMs(12.0f)
+    , gpuMs(0.0f)
+    , cooldownFrames(0)
+    , queryPending{}
+    , queryIndex(0)
+    , timing(false)
+{
+    std::fill(queries, queries + QUERY_COUNT, 0u);
+}
+
+SceneTarget::~SceneTarget() {
+    release();
+    if (queries[0] != 0) {
+        glDeleteQueries(QUERY_COUNT, queries);
+    }
+}
+
+bool SceneTarget::init(int w, int h) {
+    width = w;
+    height = h;
+    if (!allocate()) {
+        std::cerr << "ERROR::SCENETARGET: Framebuffer incomplete, rendering at native resolution" << std::endl;
+        release();
+        return false;
+    }
+    glGenQueries(QUERY_COUNT, queries);
+    return true;
+}
+
+void SceneTarget::resize(int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    // A target lost to a failed resize is retried on the next one
+    if (fbo != 0 && w == width && h == height) return;
+    width = w;
+    height = h;
+    release();
+    if (!allocate()) {
+        std::cerr << "ERROR::SCENETARGET: Resize failed, rendering at native resolution" << std::endl;
+        release();
+    }
+}
+
+void SceneTarget::setScaleRange(float minimum, float maximum) {
+    minScale = minimum;
+    maxScale = maximum;
+    scale = std::clamp(scale, minScale, maxScale);
+}
+
+bool SceneTarget::allocate() {
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenRenderbuffers(1, &colorRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRbo);
+
+    glGenRenderbuffers(1, &depthRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRbo);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+}
+
+void SceneTarget::release() {
+    if (depthRbo != 0) glDeleteRenderbuffers(1, &depthRbo);
+    if (colorRbo != 0) glDeleteRenderbuffers(1, &colorRbo);
+    if (fbo != 0) glDeleteFramebuffers(1, &fbo);
+    depthRbo = 0;
+    colorRbo = 0;
+    fbo = 0;
+}
+
+int SceneTarget::getRenderWidth() const {
+    return std::max(1, static_cast<int>(width * scale));
+}
+
+int SceneTarget::getRenderHeight() const {
+    return std::max(1, static_cast<int>(height * scale));
+}
+
+void SceneTarget::begin() {
+    if (fbo == 0) return;
+
+    collectTimings();
+    updateScale();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, getRenderWidth(), getRenderHeight());
+
+    // Skip timing this frame if the slot's previous result isn't back yet
+    timing = !queryPending[queryIndex];
+    if (timing) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex]);
+    }
+}
+
+void SceneTarget::end() {
+    if (fbo == 0) return;
+
+    if (timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[queryIndex] = true;
+        queryIndex = (queryIndex + 1) % QUERY_COUNT;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, getRenderWidth(), getRenderHeight(),
+                      0, 0, width, height,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
+
+void SceneTarget::collectTimings() {
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        if (!queryPending[i]) continue;
+
+        int available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+        queryPending[i] = false;
+
+        float ms = static_cast<float>(ns) / 1.0e6f;
+        gpuMs = (gpuMs == 0.0f) ? ms : gpuMs + 0.1f * (ms - gpuMs);
+    }
+}
+
+void SceneTarget::updateScale() {
+    if (gpuMs <= 0.0f) return;
+    if (cooldownFrames > 0) {
+        cooldownFrames--;
+        return;
+    }
+
+    float newScale = scale;
+    if (gpuMs > budgetMs) {
+        // Fill cost grows with pixel count, i.e. with scale squared
+        newScale = scale * std::sqrt(budgetMs / gpuMs);
+        newScale = std::max(newScale, scale - 0.1f);
+    } else if (gpuMs < budgetMs * 0.7f) {
+        newScale = scale + 0.05f;
+    }
+
+    newScale = std::clamp(newScale, minScale, maxScale);
+    if (std::abs(newScale - scale) > 0.01f) {
+        scale = newScale;
+        cooldownFrames = 30;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SCENETARGET_H
+#define SCENETARGET_H
+
+/**
+ * Offscreen colour/depth target for the 3D scene with dynamic resolution.
+ *
+ * The target is allocated at window size; the scene is drawn into a
+ * scaled sub-rectangle of it and upscaled to the default framebuffer
+ * with a linear blit, so changing the scale never reallocates. The scale
+ * follows the measured GPU time of the scene pass against a budget.
+ * UI is drawn afterwards at native resolution.
+ */
+class SceneTarget {
+public:
+    SceneTarget();
+    ~SceneTarget();
+
+    // Allocate the target at window size (returns false if unsupported)
+    bool init(int width, int height);
+
+    // Reallocate after a window resize (also retries after a failed one)
+    void resize(int width, int height);
+
+    // Bind the target at the current scale and start timing the scene
+    void begin();
+
+    // Stop timing, upscale to the default framebuffer, restore the viewport
+    void end();
+
+    // GPU budget for the scene pass in milliseconds
+    void setBudgetMs(float ms) { budgetMs = ms; }
+
+    // Allowed resolution scale range (fraction of window size per axis)
+    void setScaleRange(float minimum, float maximum);
+
+    float getScale() const { return scale; }
+    float getGpuMs() const { return gpuMs; }
+    bool isEnabled() const { return fbo != 0; }
+
+private:
+    unsigned int fbo;
+    unsigned int colorRbo;
+    unsigned int depthRbo;
+    int width;
+    int height;
+
+    float scale;
+    float minScale;
+    float maxScale;
+    float budgetMs;
+    float gpuMs;            // Smoothed scene GPU time
+    int cooldownFrames;     // Frames left before the next scale change
+
+    // Timer queries in flight, read back a few frames later to avoid stalls
+    static constexpr int QUERY_COUNT = 4;
+    unsigned int queries[QUERY_COUNT];
+    bool queryPending[QUERY_COUNT];
+    int queryIndex;
+    bool timing;
+
+    bool allocate();
+    void release();
+    void collectTimings();
+    void updateScale();
+
+    int getRenderWidth() const;
+    int getRenderHeight() const;
+};
+
+#endif // SCENETARGET_H
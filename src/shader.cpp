@@ -1,16 +1,20 @@
 #include "shader.h"
+#include "shadercache.h"
 #include "../glad/glad.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+ShaderCache* Shader::s_cache = nullptr;
+
 Shader::~Shader() {
     if (program_id != 0) {
         glDeleteProgram(program_id);
     }
 }
 
-bool Shader::load(const std::string& vertex_path, const std::string& fragment_path) {
+bool Shader::load(const std::string& vertex_path, const std::string& fragment_path,
+                  const std::string& defines) {
     // Read shader source files
     std::string vertex_source = readFile(vertex_path);
     std::string fragment_source = readFile(fragment_path);
@@ -20,6 +24,32 @@ bool Shader::load(const std::string& vertex_path, const std::string& fragment_pa
         return false;
     }
     
+    if (!defines.empty()) {
+        vertex_source = injectDefines(vertex_source, defines);
+        fragment_source = injectDefines(fragment_source, defines);
+    }
+    
+    // Try the program binary cache before compiling
+    uint64_t cache_key = 0;
+    if (s_cache && s_cache->isEnabled()) {
+        cache_key = s_cache->makeKey(vertex_source, fragment_source);
+        program_id = glCreateProgram();
+        if (s_cache->loadProgram(cache_key, program_id)) {
+            return true;
+        }
+        glDeleteProgram(program_id);
+        program_id = 0;
+    }
+    
+    if (!compileProgram(vertex_source, fragment_source)) return false;
+    
+    if (s_cache && s_cache->isEnabled()) {
+        s_cache->storeProgram(cache_key, program_id);
+    }
+    return true;
+}
+
+bool Shader::compileProgram(const std::string& vertex_source, const std::string& fragment_source) {
     // Compile shaders
     unsigned int vertex_shader = compileShader(GL_VERTEX_SHADER, vertex_source);
     if (vertex_shader == 0) return false;
@@ -32,6 +62,9 @@ bool Shader::load(const std::string& vertex_path, const std::string& fragment_pa
     
     // Create and link program
     program_id = glCreateProgram();
+    if (s_cache && s_cache->isEnabled()) {
+        glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glAttachShader(program_id, vertex_shader);
     glAttachShader(program_id, fragment_shader);
     glLinkProgram(program_id);
@@ -100,6 +133,19 @@ std::string Shader::readFile(const std::string& path) {
     return buffer.str();
 }
 
+std::string Shader::injectDefines(const std::string& source, const std::string& defines) {
+    // #version must stay the first directive, so insert right after it
+    size_t version = source.find("#version");
+    if (version == std::string::npos) {
+        return defines + source;
+    }
+    size_t line_end = source.find('\n', version);
+    if (line_end == std::string::npos) {
+        return source + "\n" + defines;
+    }
+    return source.substr(0, line_end + 1) + defines + source.substr(line_end + 1);
+}
+
 bool Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
     int success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+class ShaderCache;
+
 /**
  * Shader class for OpenGL shader program management.
  * Handles loading, compiling, and using vertex/fragment shaders.
@@ -16,8 +18,13 @@ public:
     Shader() : program_id(0) {}
     ~Shader();
     
-    // Load and compile shaders from file paths
-    bool load(const std::string& vertex_path, const std::string& fragment_path);
+    // Load and compile shaders from file paths. `defines` is inserted
+    // after the #version line of both stages (e.g. "#define TEXTURED\n").
+    bool load(const std::string& vertex_path, const std::string& fragment_path,
+              const std::string& defines = "");
+    
+    // Program binary cache used by every load() (nullptr disables caching)
+    static void setCache(ShaderCache* cache) { s_cache = cache; }
     
     // Activate shader program
     void use() const;
@@ -31,12 +38,20 @@ public:
     void setMat4(const std::string& name, const glm::mat4& value) const;
     
 private:
+    static ShaderCache* s_cache;
+    
+    // Compile and link from source into program_id
+    bool compileProgram(const std::string& vertex_source, const std::string& fragment_source);
+    
     // Compile a single shader from source
     unsigned int compileShader(unsigned int type, const std::string& source);
     
     // Read file contents
     std::string readFile(const std::string& path);
     
+    // Insert preprocessor lines after the #version directive
+    static std::string injectDefines(const std::string& source, const std::string& defines);
+    
     // Check compilation/linking errors
     bool checkCompileErrors(unsigned int shader, const std::string& type);
     bool checkLinkErrors(unsigned int program);
@@ -0,0 +1,159 @@
+#include "shadercache.h"
+#include "../glad/glad.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+    const uint32_t CACHE_MAGIC = 0x43534D50; // "PMSC"
+    const uint32_t CACHE_VERSION = 1;
+
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+        uint64_t key;
+    };
+
+    // 64-bit FNV-1a
+    uint64_t hashBytes(uint64_t hash, const std::string& data) {
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 0x100000001B3ull;
+        }
+        // Separator so ("ab","c") and ("a","bc") differ
+        hash ^= 0xFF;
+        hash *= 0x100000001B3ull;
+        return hash;
+    }
+
+    std::string glString(GLenum name) {
+        const GLubyte* str = glGetString(name);
+        return str ? reinterpret_cast<const char*>(str) : "";
+    }
+}
+
+ShaderCache::ShaderCache(const std::string& dir)
+    : directory(dir)
+    , enabled(false)
+    , hits(0)
+    , misses(0)
+{}
+
+bool ShaderCache::init() {
+    if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri || !glGetIntegerv) {
+        std::cout << "Shader cache disabled: program binaries not supported" << std::endl;
+        return false;
+    }
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        std::cout << "Shader cache disabled: driver exposes no binary formats" << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "ERROR::SHADERCACHE: Could not create " << directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    driverId = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    enabled = true;
+    return true;
+}
+
+uint64_t ShaderCache::makeKey(const std::string& vertex_source, const std::string& fragment_source) const {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = hashBytes(hash, driverId);
+    hash = hashBytes(hash, vertex_source);
+    hash = hashBytes(hash, fragment_source);
+    return hash;
+}
+
+std::string ShaderCache::getPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+bool ShaderCache::loadProgram(uint64_t key, unsigned int program) {
+    if (!enabled) return false;
+
+    std::string path = getPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        misses++;
+        return false;
+    }
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool valid = file && header.magic == CACHE_MAGIC && header.version == CACHE_VERSION &&
+                 header.key == key && header.length > 0;
+
+    std::vector<char> binary;
+    if (valid) {
+        binary.resize(header.length);
+        file.read(binary.data(), header.length);
+        valid = static_cast<bool>(file);
+    }
+    file.close();
+
+    if (valid) {
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        valid = success != 0;
+    }
+
+    if (!valid) {
+        // Truncated file or the driver refused it; recompile and overwrite
+        std::remove(path.c_str());
+        misses++;
+        return false;
+    }
+
+    hits++;
+    return true;
+}
+
+void ShaderCache::storeProgram(uint64_t key, unsigned int program) {
+    if (!enabled) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    CacheHeader header{CACHE_MAGIC, CACHE_VERSION, format, static_cast<uint32_t>(written), key};
+
+    // Write to a temporary file first so a crash never leaves a torn entry
+    std::string path = getPath(key);
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "ERROR::SHADERCACHE: Could not write " << tmpPath << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * On-disk cache of linked shader program binaries.
+ *
+ * Entries are keyed by a hash of the shader sources plus the driver's
+ * vendor/renderer/version strings, so a driver update or a source edit
+ * simply misses. Requires glGetProgramBinary (GL 4.1 or
+ * ARB_get_program_binary); without it the cache stays disabled and
+ * shaders compile from source as usual.
+ */
+class ShaderCache {
+public:
+    explicit ShaderCache(const std::string& directory);
+
+    // Query driver support and create the cache directory (needs a GL context)
+    bool init();
+
+    bool isEnabled() const { return enabled; }
+
+    // Cache key for a vertex/fragment source pair on this driver
+    uint64_t makeKey(const std::string& vertex_source, const std::string& fragment_source) const;
+
+    // Load a cached binary into program; false if missing or rejected
+    bool loadProgram(uint64_t key, unsigned int program);
+
+    // Store the binary of a successfully linked program
+    void storeProgram(uint64_t key, unsigned int program);
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+private:
+    std::string directory;
+    std::string driverId;
+    bool enabled;
+    int hits;
+    int misses;
+
+    std::string getPath(uint64_t key) const;
+};
+
+#endif // SHADERCACHE_H
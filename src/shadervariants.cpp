@@ -0,0 +1,42 @@
+#include "shadervariants.h"
+#include <iostream>
+
+ShaderVariants::ShaderVariants(const std::string& vertex_path, const std::string& fragment_path)
+    : vertexPath(vertex_path)
+    , fragmentPath(fragment_path)
+{}
+
+std::string ShaderVariants::buildDefines(uint32_t features) {
+    std::string defines;
+    if (features & SHADER_TEXTURED)     defines += "#define TEXTURED\n";
+    if (features & SHADER_INSTANCED)    defines += "#define INSTANCED\n";
+    if (features & SHADER_VERTEX_COLOR) defines += "#define VERTEX_COLOR\n";
+    if (features & SHADER_FOG)          defines += "#define FOG\n";
+    return defines;
+}
+
+Shader* ShaderVariants::get(uint32_t features) {
+    auto it = variants.find(features);
+    if (it != variants.end()) {
+        return it->second.get();
+    }
+
+    auto shader = std::make_unique<Shader>();
+    if (!shader->load(vertexPath, fragmentPath, buildDefines(features))) {
+        std::cerr << "ERROR::SHADER: Variant 0x" << std::hex << features << std::dec
+                  << " failed to build" << std::endl;
+        shader.reset();
+    }
+
+    Shader* result = shader.get();
+    variants[features] = std::move(shader);
+    return result;
+}
+
+bool ShaderVariants::prewarm(const std::vector<uint32_t>& feature_sets) {
+    bool ok = true;
+    for (uint32_t features : feature_sets) {
+        if (!get(features)) ok = false;
+    }
+    return ok;
+}
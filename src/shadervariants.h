@@ -0,0 +1,47 @@
+#ifndef SHADERVARIANTS_H
+#define SHADERVARIANTS_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "shader.h"
+
+/**
+ * Compile-time shader features. Each set bit becomes a #define in both
+ * stages, so a program only contains the code its draw path needs.
+ */
+enum ShaderFeature : uint32_t {
+    SHADER_TEXTURED     = 1u << 0,  // Sample textureSampler for base colour
+    SHADER_INSTANCED    = 1u << 1,  // Model matrix from per-instance attributes
+    SHADER_VERTEX_COLOR = 1u << 2,  // Base colour from the vertex colour attribute
+    SHADER_FOG          = 1u << 3   // Linear distance fog toward fogColor
+};
+
+/**
+ * ShaderVariants owns every permutation of one vertex/fragment pair.
+ * Variants are compiled on first use or up front with prewarm().
+ */
+class ShaderVariants {
+public:
+    ShaderVariants(const std::string& vertex_path, const std::string& fragment_path);
+
+    // Program for a feature mask (nullptr if it failed to compile)
+    Shader* get(uint32_t features);
+
+    // Compile the given variants now; returns false if any failed
+    bool prewarm(const std::vector<uint32_t>& feature_sets);
+
+    // "#define ..." lines for a feature mask
+    static std::string buildDefines(uint32_t features);
+
+private:
+    std::string vertexPath;
+    std::string fragmentPath;
+
+    // Failed variants stay in the map as nullptr so they aren't retried
+    std::map<uint32_t, std::unique_ptr<Shader>> variants;
+};
+
+#endif // SHADERVARIANTS_H
@@ -0,0 +1,129 @@
+#include "simbot.h"
+#include "simulation.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    const Direction ALL_DIRECTIONS[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+    Direction parseDirection(char c) {
+        switch (c) {
+            case 'U': case 'u': return Direction::UP;
+            case 'D': case 'd': return Direction::DOWN;
+            case 'L': case 'l': return Direction::LEFT;
+            case 'R': case 'r': return Direction::RIGHT;
+            default:            return Direction::NONE;
+        }
+    }
+}
+
+bool ScriptedInput::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SIMBOT: Could not open script: " << path << std::endl;
+        return false;
+    }
+
+    entries.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream stream(line);
+        uint64_t tick = 0;
+        std::string dir;
+        if (!(stream >> tick >> dir) || dir.empty() || parseDirection(dir[0]) == Direction::NONE) {
+            std::cerr << "ERROR::SIMBOT: Bad script line " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+        entries.push_back({tick, parseDirection(dir[0])});
+    }
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.tick < b.tick; });
+    cursor = 0;
+    return true;
+}
+
+Direction ScriptedInput::getInput(const Simulation&, uint64_t tick) {
+    Direction input = Direction::NONE;
+    while (cursor < entries.size() && entries[cursor].tick <= tick) {
+        input = entries[cursor].dir;
+        cursor++;
+    }
+    return input;
+}
+
+RandomBot::RandomBot(uint32_t seed)
+    : seed(seed)
+    , rng(seed)
+{}
+
+Direction RandomBot::getInput(const Simulation& sim, uint64_t) {
+    const PacMan& pacman = sim.pacman;
+    if (pacman.is_moving || pacman.isDead) return Direction::NONE;
+
+    Direction options[4];
+    int count = 0;
+    for (Direction dir : ALL_DIRECTIONS) {
+        if (sim.maze.getNeighbour(pacman.grid_x, pacman.grid_y, dir) != Maze::NO_NEIGHBOUR) {
+            options[count++] = dir;
+        }
+    }
+    if (count == 0) return Direction::NONE;
+
+    // Keep going through corridors; only choose at junctions
+    if (count <= 2 && pacman.current_dir != Direction::NONE &&
+        sim.maze.getNeighbour(pacman.grid_x, pacman.grid_y, pacman.current_dir) != Maze::NO_NEIGHBOUR) {
+        return Direction::NONE;
+    }
+    return options[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+}
+
+Direction GreedyBot::getInput(const Simulation& sim, uint64_t) {
+    const PacMan& pacman = sim.pacman;
+    const Maze& maze = sim.maze;
+    if (pacman.is_moving || pacman.isDead) return Direction::NONE;
+
+    int width = maze.getWidth();
+    int tileCount = width * maze.getHeight();
+    visited.assign(tileCount, 0);
+    firstStep.assign(tileCount, Direction::NONE);
+
+    // Mark ghosts and their neighbours as walls (1 = blocked, 2 = seen)
+    for (const Ghost& ghost : sim.ghosts) {
+        if (ghost.isEaten || ghost.mode == GhostMode::FRIGHTENED) continue;
+        uint32_t index = static_cast<uint32_t>(ghost.grid_y * width + ghost.grid_x);
+        visited[index] = 1;
+        for (Direction dir : ALL_DIRECTIONS) {
+            uint32_t next = maze.getNeighbour(ghost.grid_x, ghost.grid_y, dir);
+            if (next != Maze::NO_NEIGHBOUR) visited[next] = 1;
+        }
+    }
+
+    int start = pacman.grid_y * width + pacman.grid_x;
+    visited[start] = 2;
+    queue.clear();
+    queue.push_back(start);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int index = queue[head];
+        TileType tile = maze.getTile(index % width, index / width);
+        if (index != start && (tile == TileType::PELLET || tile == TileType::POWER)) {
+            return firstStep[index];
+        }
+
+        for (Direction dir : ALL_DIRECTIONS) {
+            uint32_t next = maze.getNeighbour(static_cast<uint32_t>(index), dir);
+            if (next == Maze::NO_NEIGHBOUR || visited[next] != 0) continue;
+            visited[next] = 2;
+            firstStep[next] = (index == start) ? dir : firstStep[index];
+            queue.push_back(static_cast<int>(next));
+        }
+    }
+    return Direction::NONE;
+}
@@ -0,0 +1,73 @@
+#ifndef SIMBOT_H
+#define SIMBOT_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "entity.h"
+
+class Simulation;
+
+/**
+ * Source of player input for a simulation without a keyboard
+ * (headless runs, tests, tuning).
+ */
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    // Direction to feed into Simulation::step for this tick (NONE = no input)
+    virtual Direction getInput(const Simulation& sim, uint64_t tick) = 0;
+
+    // Called before each new game
+    virtual void reset() {}
+};
+
+/**
+ * Replays a text script of "<tick> <U|D|L|R>" lines.
+ */
+class ScriptedInput : public InputSource {
+public:
+    bool load(const std::string& path);
+    Direction getInput(const Simulation& sim, uint64_t tick) override;
+    void reset() override { cursor = 0; }
+
+private:
+    struct Entry {
+        uint64_t tick;
+        Direction dir;
+    };
+    std::vector<Entry> entries;
+    size_t cursor = 0;
+};
+
+/**
+ * Picks a random open direction at junctions.
+ */
+class RandomBot : public InputSource {
+public:
+    explicit RandomBot(uint32_t seed);
+    Direction getInput(const Simulation& sim, uint64_t tick) override;
+    void reset() override { rng.seed(seed); }
+
+private:
+    uint32_t seed;
+    std::mt19937 rng;
+};
+
+/**
+ * Walks the shortest path to the nearest pellet, treating tiles next to
+ * non-frightened ghosts as blocked.
+ */
+class GreedyBot : public InputSource {
+public:
+    Direction getInput(const Simulation& sim, uint64_t tick) override;
+
+private:
+    std::vector<int> visited;
+    std::vector<Direction> firstStep;
+    std::vector<int> queue;
+};
+
+#endif // SIMBOT_H
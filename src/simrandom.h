@@ -0,0 +1,29 @@
+#ifndef SIMRANDOM_H
+#define SIMRANDOM_H
+
+#include <cstdint>
+
+/**
+ * Small deterministic RNG for game rules (xorshift64* seeded through
+ * splitmix64). Identical on every platform and standard library, so a
+ * seed plus inputs reproduces a game exactly.
+ */
+struct SimRandom {
+    uint64_t state = 0;
+
+    void seed(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        state = value ^ (value >> 31);
+    }
+
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+};
+
+#endif // SIMRANDOM_H
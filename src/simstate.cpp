@@ -0,0 +1,42 @@
+#include "simstate.h"
+#include "maze.h"
+
+std::shared_ptr<const PelletBoard> PelletBoard::capture(const Maze& maze) {
+    auto board = std::make_shared<PelletBoard>();
+    board->width = maze.getWidth();
+    board->height = maze.getHeight();
+
+    size_t words = (static_cast<size_t>(board->width) * board->height + 63) / 64;
+    board->pellets.assign(words, 0);
+    board->powers.assign(words, 0);
+
+    for (int y = 0; y < board->height; y++) {
+        for (int x = 0; x < board->width; x++) {
+            size_t index = static_cast<size_t>(y) * board->width + x;
+            TileType tile = maze.getTile(x, y);
+            if (tile == TileType::PELLET) board->pellets[index / 64] |= 1ull << (index % 64);
+            else if (tile == TileType::POWER) board->powers[index / 64] |= 1ull << (index % 64);
+        }
+    }
+    return board;
+}
+
+void PelletBoard::restore(Maze& maze, const PelletBoard& from, const PelletBoard& to) {
+    if (from.width != to.width || from.height != to.height) return;
+
+    for (size_t word = 0; word < to.pellets.size(); word++) {
+        uint64_t changed = (from.pellets[word] ^ to.pellets[word]) | (from.powers[word] ^ to.powers[word]);
+        while (changed) {
+            int bit = 0;
+            while (!((changed >> bit) & 1u)) bit++;
+            changed &= changed - 1;
+
+            size_t index = word * 64 + bit;
+            uint64_t mask = 1ull << bit;
+            TileType tile = (to.pellets[word] & mask) ? TileType::PELLET
+                          : (to.powers[word] & mask) ? TileType::POWER
+                          : TileType::FLOOR;
+            maze.setTile(static_cast<int>(index % to.width), static_cast<int>(index / to.width), tile);
+        }
+    }
+}
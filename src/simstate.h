@@ -0,0 +1,51 @@
+#ifndef SIMSTATE_H
+#define SIMSTATE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "pacman.h"
+#include "ghost.h"
+
+class Maze;
+
+/**
+ * Immutable pellet layer of a maze: one bit per tile (index y * width + x)
+ * for pellets and for power pellets. Snapshots share a board until a
+ * pellet is eaten, so taking one never copies the maze.
+ */
+struct PelletBoard {
+    int width = 0;
+    int height = 0;
+    std::vector<uint64_t> pellets;
+    std::vector<uint64_t> powers;
+
+    static std::shared_ptr<const PelletBoard> capture(const Maze& maze);
+
+    // Rewrite only the tiles that differ between from (the maze's current
+    // pellets) and to
+    static void restore(Maze& maze, const PelletBoard& from, const PelletBoard& to);
+};
+
+/**
+ * Plain-data snapshot of everything the rules read: a few hundred bytes
+ * of packed entity state plus a shared pellet board. Copying one is a
+ * memcpy and a reference count; Simulation::loadState puts it back.
+ */
+struct SimState {
+    static constexpr int GHOST_COUNT = 4;
+
+    uint64_t tick = 0;
+    uint64_t rngState = 0;
+    float deathTimer = 0.0f;
+    int32_t ghostEatBonus = 0;
+    int32_t lastScore = 0;
+    bool gameOver = false;
+    bool levelCleared = false;
+
+    PacManState pacman{};
+    GhostState ghosts[GHOST_COUNT]{};
+    std::shared_ptr<const PelletBoard> pellets;
+};
+
+#endif // SIMSTATE_H
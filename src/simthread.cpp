@@ -0,0 +1,279 @@
+#include "simthread.h"
+#include "mctsbot.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace {
+    glm::vec3 getGhostTint(GhostType type) {
+        switch (type) {
+            case GhostType::BLINKY: return glm::vec3(1.0f, 0.2f, 0.2f);
+            case GhostType::PINKY:  return glm::vec3(1.0f, 0.6f, 0.8f);
+            case GhostType::INKY:   return glm::vec3(0.2f, 0.8f, 1.0f);
+            case GhostType::CLYDE:  return glm::vec3(1.0f, 0.6f, 0.2f);
+            default: return glm::vec3(1.0f);
+        }
+    }
+
+    const glm::vec3 PACMAN_TINT(1.0f, 1.0f, 0.2f);
+    const glm::vec3 FRIGHTENED_TINT(0.2f, 0.2f, 1.0f);
+}
+
+SimulationThread::SimulationThread()
+    : running(false)
+    , paused(true)
+    , tick(0)
+    , levelHash(0)
+    , levelSerial(0)
+    , recordingActive(false)
+    , replaySpeed(1.0f)
+    , autoplayActive(false)
+{}
+
+SimulationThread::~SimulationThread() {
+    stop();
+    SimCommand cmd;
+    while (commandQueue.pop(cmd)) delete cmd.level;
+}
+
+bool SimulationThread::init(const std::string& level_path) {
+    if (!sim.init(level_path)) return false;
+    levelHash = ReplayLog::hashLevel(level_path);
+    publishSnapshot(sim);
+    return true;
+}
+
+bool SimulationThread::init(std::unique_ptr<PreparedLevel> level) {
+    if (!level || !sim.init(std::move(level->maze), level->path)) return false;
+    levelHash = level->hash;
+    publishSnapshot(sim);
+    return true;
+}
+
+bool SimulationThread::startReplay(const std::string& replay_path) {
+    ReplayLog log;
+    if (!log.load(replay_path)) return false;
+
+    auto player = std::make_unique<ReplayPlayer>();
+    if (!player->start(log, sim.getLevelPath())) return false;
+
+    std::cout << "Replaying " << replay_path << ": " << log.totalTicks << " ticks, "
+              << log.inputs.size() << " inputs" << std::endl;
+    replay = std::move(player);
+    publishSnapshot(replay->getSimulation());
+    return true;
+}
+
+void SimulationThread::start() {
+    if (running) return;
+    running = true;
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    // Keep an unfinished session too; it is usually the one worth reporting
+    if (recordingActive) {
+        saveRecording();
+    }
+}
+
+bool SimulationThread::send(SimCommandType type, Direction dir) {
+    if (!commandQueue.push({type, dir, nullptr})) {
+        std::cerr << "WARNING::SIMTHREAD: Command queue full, dropping command" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SimulationThread::sendLevel(std::unique_ptr<PreparedLevel>& level) {
+    // The level rides in the command; ownership only moves once it is queued
+    if (!level) return false;
+    if (!commandQueue.push({SimCommandType::LOAD_LEVEL, Direction::NONE, level.get()})) {
+        std::cerr << "WARNING::SIMTHREAD: Command queue full, level not sent" << std::endl;
+        return false;
+    }
+    level.release();
+    return true;
+}
+
+const RenderSnapshot& SimulationThread::acquireSnapshot() {
+    snapshots.update();
+    return snapshots.getFront();
+}
+
+Direction SimulationThread::processCommands() {
+    Direction input = Direction::NONE;
+    SimCommand cmd;
+    while (commandQueue.pop(cmd)) {
+        switch (cmd.type) {
+            case SimCommandType::INPUT:    input = cmd.dir; break;
+            case SimCommandType::NEW_GAME: newGame(); break;
+            case SimCommandType::LOAD_LEVEL: {
+                std::unique_ptr<PreparedLevel> level(cmd.level);
+                // A replay stays on the level it was recorded on
+                if (replay) break;
+                if (recordingActive) saveRecording();
+                sim.init(std::move(level->maze), level->path);
+                levelHash = level->hash;
+                levelSerial++;
+                newGame();
+                break;
+            }
+            case SimCommandType::PAUSE:    paused = true; break;
+            case SimCommandType::RESUME:   paused = false; break;
+            case SimCommandType::TOGGLE_AUTOPLAY:
+                if (!autoplay) {
+                    // Leave a core each for the GL and simulation threads
+                    unsigned int cores = std::thread::hardware_concurrency();
+                    autoplay = std::make_unique<MctsBot>(AUTOPLAY_BUDGET_MS, cores > 2 ? cores - 2 : 1);
+                }
+                autoplayActive = !autoplayActive;
+                std::cout << "Autoplay " << (autoplayActive ? "on" : "off") << std::endl;
+                break;
+        }
+    }
+    return input;
+}
+
+void SimulationThread::newGame() {
+    if (replay) {
+        replay->seek(0);
+        return;
+    }
+    if (recordingActive) saveRecording();
+    sim.setSeed(std::random_device{}());
+    sim.newGame();
+    if (autoplay) autoplay->reset();
+    recording.begin(sim.getSeed(), levelHash, static_cast<uint32_t>(TICK_RATE));
+    recordingActive = true;
+}
+
+void SimulationThread::stepLive(float dt, Direction input) {
+    if (recordingActive) {
+        recording.record(sim.getTick(), input);
+    }
+    sim.step(dt, input);
+
+    if (recordingActive && sim.gameOver) {
+        saveRecording();
+    }
+}
+
+void SimulationThread::saveRecording() {
+    recording.finish(sim);
+    recordingActive = false;
+    if (recording.save(LAST_REPLAY_PATH)) {
+        std::cout << "Saved replay: " << LAST_REPLAY_PATH << " (" << recording.inputs.size() << " inputs)" << std::endl;
+    }
+}
+
+void SimulationThread::run() {
+    using Clock = std::chrono::steady_clock;
+    const float dt = static_cast<float>(1.0 / TICK_RATE);
+
+    Clock::time_point nextTick = Clock::now();
+
+    while (running) {
+        Direction input = processCommands();
+
+        // Replays run faster or slower by shortening the tick period
+        double speed = replay ? std::max(0.05, static_cast<double>(replaySpeed.load())) : 1.0;
+        const auto tickDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / (TICK_RATE * speed)));
+        Simulation& current = replay ? replay->getSimulation() : sim;
+        // The backlog limit covers the same wall time at any speed, so a
+        // 64x replay isn't held back by how often the thread wakes up
+        const int maxCatchup = static_cast<int>(std::ceil(MAX_CATCHUP_TICKS * std::max(1.0, speed)));
+
+        // Run every tick that is due; a slow GL frame never holds these back
+        int ticksRun = 0;
+        Clock::time_point now = Clock::now();
+        while (nextTick <= now && ticksRun < maxCatchup) {
+            if (!paused) {
+                if (replay) {
+                    replay->step();
+                } else {
+                    // The bot plays unless a key was pressed this tick
+                    if (autoplayActive && input == Direction::NONE) {
+                        input = autoplay->getInput(sim, sim.getTick());
+                    }
+                    stepLive(dt, input);
+                }
+                input = Direction::NONE;
+                tick++;
+
+                for (const SimEvent& event : current.events) {
+                    eventQueue.push(event);
+                }
+                current.events.clear();
+            }
+            nextTick += tickDuration;
+            ticksRun++;
+        }
+
+        // Too far behind (debugger, suspended process): drop the backlog
+        if (ticksRun == maxCatchup) {
+            nextTick = now + tickDuration;
+        }
+
+        if (ticksRun > 0) {
+            publishSnapshot(current);
+        }
+
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void SimulationThread::publishSnapshot(const Simulation& current) {
+    RenderSnapshot& snap = snapshots.getBack();
+    const PacMan& pacman = current.pacman;
+
+    snap.tick = tick;
+    snap.level = levelSerial;
+    snap.score = pacman.score;
+    snap.lives = pacman.lives;
+    snap.gameOver = current.gameOver;
+
+    snap.pacman.world_pos = pacman.world_pos;
+    snap.pacman.tint = PACMAN_TINT;
+    snap.pacman.dir = pacman.current_dir;
+    snap.pacman.is_moving = pacman.is_moving;
+    snap.pacman.visible = !pacman.isDead;
+
+    snap.ghosts.resize(current.ghosts.size());
+    for (size_t i = 0; i < current.ghosts.size(); i++) {
+        const Ghost& ghost = current.ghosts[i];
+        EntitySnapshot& out = snap.ghosts[i];
+        out.world_pos = ghost.world_pos;
+        out.tint = (ghost.mode == GhostMode::FRIGHTENED) ? FRIGHTENED_TINT : getGhostTint(ghost.ghost_type);
+        out.dir = ghost.current_dir;
+        out.is_moving = ghost.is_moving;
+        out.visible = !ghost.isEaten;
+    }
+
+    // Each slot keeps its own pellet copy; only rebuild it when stale
+    const Maze& maze = current.maze;
+    size_t tileCount = static_cast<size_t>(maze.getWidth()) * maze.getHeight();
+    size_t words = (tileCount + 63) / 64;
+    if (snap.pelletVersion != current.pelletVersion || snap.pellets.size() != words) {
+        snap.pellets.assign(words, 0);
+        snap.powers.assign(words, 0);
+        for (int y = 0; y < maze.getHeight(); ++y) {
+            for (int x = 0; x < maze.getWidth(); ++x) {
+                int index = y * maze.getWidth() + x;
+                TileType tile = maze.getTile(x, y);
+                if (tile == TileType::PELLET) snap.pellets[index >> 6] |= uint64_t(1) << (index & 63);
+                else if (tile == TileType::POWER) snap.powers[index >> 6] |= uint64_t(1) << (index & 63);
+            }
+        }
+        snap.pelletVersion = current.pelletVersion;
+    }
+
+    snapshots.publish();
+}
@@ -0,0 +1,152 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "levelmanager.h"
+#include "replay.h"
+#include "simbot.h"
+#include "simulation.h"
+#include "spscqueue.h"
+#include "triplebuffer.h"
+
+/**
+ * Render-side view of one entity.
+ */
+struct EntitySnapshot {
+    glm::vec3 world_pos{0.0f};
+    glm::vec3 tint{1.0f};
+    Direction dir = Direction::NONE;
+    bool is_moving = false;
+    bool visible = false;
+};
+
+/**
+ * Immutable copy of everything the GL thread needs to draw one frame.
+ * Pellet state is a bitset over maze tiles (index y * width + x).
+ */
+struct RenderSnapshot {
+    uint64_t tick = 0;
+    unsigned int level = 0;     // levels swapped in since init()
+    EntitySnapshot pacman;
+    std::vector<EntitySnapshot> ghosts;
+
+    unsigned int pelletVersion = 0;
+    std::vector<uint64_t> pellets;
+    std::vector<uint64_t> powers;
+
+    int score = 0;
+    int lives = 0;
+    bool gameOver = false;
+
+    bool hasPellet(int index) const { return (pellets[index >> 6] >> (index & 63)) & 1u; }
+    bool hasPower(int index) const { return (powers[index >> 6] >> (index & 63)) & 1u; }
+};
+
+/**
+ * Commands sent from the GL/input thread to the simulation.
+ */
+enum class SimCommandType {
+    INPUT,
+    NEW_GAME,
+    LOAD_LEVEL,     // swap in the level passed to sendLevel() and start a game
+    PAUSE,
+    RESUME,
+    TOGGLE_AUTOPLAY
+};
+
+struct SimCommand {
+    SimCommandType type;
+    Direction dir;
+    PreparedLevel* level;       // LOAD_LEVEL only; owned while queued
+};
+
+/**
+ * SimulationThread runs a Simulation at a fixed tick rate on its own
+ * thread. The GL thread talks to it only through lock-free channels:
+ * commands in, events out, and a triple-buffered RenderSnapshot.
+ */
+class SimulationThread {
+public:
+    SimulationThread();
+    ~SimulationThread();
+
+    // Load the level; publishes an initial snapshot. Call before start().
+    bool init(const std::string& level_path);
+    bool init(std::unique_ptr<PreparedLevel> level);
+
+    // Play a recording instead of live input. Call after init(), before
+    // start(); NEW_GAME then restarts the replay from the beginning.
+    bool startReplay(const std::string& replay_path);
+
+    // Replay playback rate (1 = real time)
+    void setReplaySpeed(float speed) { replaySpeed = speed; }
+    float getReplaySpeed() const { return replaySpeed; }
+    bool isReplaying() const { return replay != nullptr; }
+
+    void start();
+    void stop();
+
+    // GL thread: queue a command (returns false if the queue is full)
+    bool send(SimCommandType type, Direction dir = Direction::NONE);
+
+    // GL thread: hand over a prepared level and queue LOAD_LEVEL. The
+    // swap happens between two ticks; snapshots from then on carry the
+    // next level number. On false nothing was queued and level is left
+    // with the caller.
+    bool sendLevel(std::unique_ptr<PreparedLevel>& level);
+
+    // GL thread: next pending event
+    bool pollEvent(SimEvent& event) { return eventQueue.pop(event); }
+
+    // GL thread: latest published snapshot
+    const RenderSnapshot& acquireSnapshot();
+
+    static constexpr double TICK_RATE = 120.0;
+
+    // Search time per decision for the autoplay bot (Pac-Man decides
+    // about every 22 ticks, so this stays well inside the tick budget)
+    static constexpr double AUTOPLAY_BUDGET_MS = 4.0;
+
+    // Most ticks run per wake-up at normal speed; replays scale it up
+    static constexpr int MAX_CATCHUP_TICKS = 8;
+
+    // Every live game is recorded here when it ends (or on shutdown)
+    static constexpr const char* LAST_REPLAY_PATH = "replays/last.pmr";
+
+private:
+    Simulation sim;
+    std::thread thread;
+    std::atomic<bool> running;
+    bool paused;
+    uint64_t tick;
+    uint64_t levelHash;         // of the level file, for recordings
+    unsigned int levelSerial;
+
+    ReplayLog recording;
+    bool recordingActive;
+    std::unique_ptr<ReplayPlayer> replay;
+    std::atomic<float> replaySpeed;
+
+    // Bot that plays when autoplay is on (created on first use)
+    std::unique_ptr<InputSource> autoplay;
+    bool autoplayActive;
+
+    SpscQueue<SimCommand, 256> commandQueue;
+    SpscQueue<SimEvent, 256> eventQueue;
+    TripleBuffer<RenderSnapshot> snapshots;
+
+    void run();
+    Direction processCommands();
+    void newGame();
+    void stepLive(float dt, Direction input);
+    void saveRecording();
+    void publishSnapshot(const Simulation& current);
+};
+
+#endif // SIMTHREAD_H
@@ -0,0 +1,312 @@
+#include "simulation.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    uint64_t hashValue(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    uint64_t hashField(uint64_t hash, const T& value) {
+        return hashValue(hash, &value, sizeof(T));
+    }
+}
+
+Simulation::Simulation()
+    : gameOver(false)
+    , levelCleared(false)
+    , pelletVersion(0)
+    , logging(true)
+    , deathTimer(0.0f)
+    , ghostEatBonus(FIRST_GHOST_BONUS)
+    , lastScore(0)
+    , seed(0)
+    , tick(0)
+    , boardVersion(0)
+{
+    rng.seed(0);
+    ghosts.emplace_back(GhostType::BLINKY);
+    ghosts.emplace_back(GhostType::PINKY);
+    ghosts.emplace_back(GhostType::INKY);
+    ghosts.emplace_back(GhostType::CLYDE);
+}
+
+bool Simulation::init(const std::string& level_path, bool precompute_paths) {
+    levelPath = level_path;
+    if (!maze.load(levelPath)) return false;
+
+    maze.setPathTable(precompute_paths ? PathTable::loadOrBuild(maze, levelPath + ".paths") : nullptr);
+    startLevel();
+    return true;
+}
+
+bool Simulation::init(const Maze& layout, bool precompute_paths) {
+    if (layout.getWidth() == 0) return false;
+    levelPath.clear();
+    maze = layout;
+    if (!precompute_paths) {
+        maze.setPathTable(nullptr);
+    } else if (!maze.getPathTable()) {
+        auto table = std::make_shared<PathTable>();
+        if (table->build(maze)) maze.setPathTable(table);
+    }
+    startLevel();
+    return true;
+}
+
+bool Simulation::init(Maze&& level, const std::string& level_path) {
+    if (level.getWidth() == 0) return false;
+    levelPath = level_path;
+    maze = std::move(level);
+    startLevel();
+    return true;
+}
+
+void Simulation::startLevel() {
+    buildInfluence();
+    const LevelInfo& info = maze.getInfo();
+    pacman.setSpawn(info.pacmanSpawn.x, info.pacmanSpawn.y);
+    pacman.setGridPosition(info.pacmanSpawn.x, info.pacmanSpawn.y, maze);
+    for (size_t i = 0; i < ghosts.size(); i++) {
+        ghosts[i].respawn(maze, info.ghostSpawns[i].x, info.ghostSpawns[i].y);
+    }
+    rng.seed(seed);
+    tick = 0;
+    pelletVersion++;
+    startBoard = PelletBoard::capture(maze);
+    pelletBoard = startBoard;
+    boardVersion = pelletVersion;
+}
+
+void Simulation::newGame() {
+    gameOver = false;
+    levelCleared = false;
+    pacman.lives = 3;
+    pacman.score = 0;
+    lastScore = 0;
+    if (startBoard) {
+        if (!pelletBoard || boardVersion != pelletVersion) pelletBoard = PelletBoard::capture(maze);
+        if (pelletBoard != startBoard) PelletBoard::restore(maze, *pelletBoard, *startBoard);
+    }
+    respawnAll();
+    ghostEatBonus = FIRST_GHOST_BONUS;
+    deathTimer = 0.0f;
+    rng.seed(seed);
+    tick = 0;
+    pelletVersion++;
+    pelletBoard = startBoard;
+    boardVersion = pelletVersion;
+}
+
+void Simulation::buildInfluence() {
+    influence.build(maze, maze.getInfo().ghostSpawns, LevelInfo::GHOST_COUNT);
+}
+
+void Simulation::setLogging(bool enabled) {
+    logging = enabled;
+    pacman.logging = enabled;
+}
+
+void Simulation::setSeed(uint64_t new_seed) {
+    seed = new_seed;
+}
+
+uint64_t Simulation::checksum() const {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = hashField(hash, tick);
+    hash = hashField(hash, rng.state);
+    hash = hashField(hash, gameOver);
+    hash = hashField(hash, deathTimer);
+
+    auto hashEntity = [&hash](const Entity& entity) {
+        hash = hashField(hash, entity.grid_x);
+        hash = hashField(hash, entity.grid_y);
+        hash = hashField(hash, entity.world_pos);
+        hash = hashField(hash, entity.current_dir);
+        hash = hashField(hash, entity.move_elapsed);
+    };
+
+    hashEntity(pacman);
+    hash = hashField(hash, pacman.score);
+    hash = hashField(hash, pacman.lives);
+    hash = hashField(hash, pacman.isDead);
+    for (const Ghost& ghost : ghosts) {
+        hashEntity(ghost);
+        hash = hashField(hash, ghost.mode);
+        hash = hashField(hash, ghost.isEaten);
+    }
+
+    for (uint64_t row : maze.getBits().getPelletRows()) hash = hashField(hash, row);
+    for (uint64_t row : maze.getBits().getPowerRows()) hash = hashField(hash, row);
+    return hash;
+}
+
+void Simulation::saveState(SimState& state) const {
+    if (!pelletBoard || boardVersion != pelletVersion) {
+        pelletBoard = PelletBoard::capture(maze);
+        boardVersion = pelletVersion;
+    }
+
+    state.tick = tick;
+    state.rngState = rng.state;
+    state.deathTimer = deathTimer;
+    state.ghostEatBonus = ghostEatBonus;
+    state.lastScore = lastScore;
+    state.gameOver = gameOver;
+    state.levelCleared = levelCleared;
+    pacman.saveState(state.pacman);
+    for (size_t i = 0; i < ghosts.size() && i < SimState::GHOST_COUNT; i++) {
+        ghosts[i].saveState(state.ghosts[i]);
+    }
+    state.pellets = pelletBoard;
+}
+
+void Simulation::loadState(const SimState& state) {
+    if (state.pellets) {
+        if (!pelletBoard || boardVersion != pelletVersion) {
+            pelletBoard = PelletBoard::capture(maze);
+            boardVersion = pelletVersion;
+        }
+        // Same board as the maze holds: nothing to rewrite
+        if (state.pellets != pelletBoard) {
+            PelletBoard::restore(maze, *pelletBoard, *state.pellets);
+            pelletVersion++;
+            pelletBoard = state.pellets;
+            boardVersion = pelletVersion;
+        }
+    }
+
+    tick = state.tick;
+    rng.state = state.rngState;
+    deathTimer = state.deathTimer;
+    ghostEatBonus = state.ghostEatBonus;
+    lastScore = state.lastScore;
+    gameOver = state.gameOver;
+    levelCleared = state.levelCleared;
+    pacman.loadState(state.pacman);
+    for (size_t i = 0; i < ghosts.size() && i < SimState::GHOST_COUNT; i++) {
+        ghosts[i].loadState(state.ghosts[i]);
+    }
+}
+
+void Simulation::respawnAll() {
+    const LevelInfo& info = maze.getInfo();
+    pacman.setSpawn(info.pacmanSpawn.x, info.pacmanSpawn.y);
+    pacman.respawn(maze);
+    for (size_t i = 0; i < ghosts.size(); i++) {
+        ghosts[i].respawn(maze, info.ghostSpawns[i].x, info.ghostSpawns[i].y);
+    }
+}
+
+void Simulation::resolveCollisions() {
+    if (pacman.isDead || levelCleared) return;
+
+    const int width = maze.getWidth();
+    size_t tileCount = static_cast<size_t>(width) * maze.getHeight();
+    if (collisionGrid.getTileCount() != tileCount) collisionGrid.resize(tileCount);
+    collisionGrid.clear();
+    for (size_t i = 0; i < ghosts.size(); i++) {
+        const Ghost& ghost = ghosts[i];
+        if (ghost.isEaten) continue;
+        collisionGrid.insert(static_cast<uint32_t>(ghost.grid_y * width + ghost.grid_x), static_cast<int32_t>(i));
+    }
+
+    // Sharing a tile, or crossing the same edge in opposite directions
+    // (tryMove moves grid_x/grid_y at the start of a step, so a swap
+    // never shows up as a shared tile)
+    collisionHits.clear();
+    uint32_t pacmanTile = static_cast<uint32_t>(pacman.grid_y * width + pacman.grid_x);
+    for (int32_t id = collisionGrid.first(pacmanTile); id != CollisionGrid::END; id = collisionGrid.next(id)) {
+        collisionHits.push_back(id);
+    }
+    uint32_t pacmanFrom = pacman.getPreviousTile(maze);
+    if (pacmanFrom != Maze::NO_NEIGHBOUR) {
+        for (int32_t id = collisionGrid.first(pacmanFrom); id != CollisionGrid::END; id = collisionGrid.next(id)) {
+            if (ghosts[id].getPreviousTile(maze) == pacmanTile) collisionHits.push_back(id);
+        }
+    }
+    std::sort(collisionHits.begin(), collisionHits.end());
+
+    for (int32_t id : collisionHits) {
+        Ghost& ghost = ghosts[id];
+        if (pacman.isDead) break;
+        if (ghost.mode == GhostMode::FRIGHTENED) {
+            ghost.isEaten = true;
+            pacman.score += ghostEatBonus;
+            if (logging) std::cout << "Ate ghost! +" << ghostEatBonus << std::endl;
+            ghostEatBonus *= 2;
+        } else {
+            pacman.die();
+            events.push_back({SimEventType::PACMAN_DIED, pacman.score});
+            deathTimer = DEATH_DELAY;
+        }
+    }
+}
+
+void Simulation::step(float dt, Direction input) {
+    tick++;
+    if (!gameOver && !pacman.isDead) {
+        if (input != Direction::NONE) {
+            pacman.handleInput(input, maze);
+        }
+        pacman.continueMovement(maze);
+        pacman.update(dt);
+
+        int pelletsBefore = pacman.pelletsEaten;
+        if (pacman.collectPellet(maze)) {
+            ghostEatBonus = FIRST_GHOST_BONUS;
+            for (auto& ghost : ghosts) ghost.setFrightened(PacMan::POWER_DURATION);
+        }
+        if (pacman.pelletsEaten != pelletsBefore) {
+            pelletVersion++;
+            if (maze.isCleared()) {
+                gameOver = true;
+                levelCleared = true;
+                if (logging) std::cout << "\n=== LEVEL CLEARED === Score: " << pacman.score << std::endl;
+                events.push_back({SimEventType::LEVEL_CLEARED, pacman.score});
+            }
+        }
+
+        if (pacman.score != lastScore) {
+            events.push_back({SimEventType::SCORE_CHANGED, pacman.score});
+            lastScore = pacman.score;
+            if (logging) std::cout << "Score: " << pacman.score << std::endl;
+        }
+
+        glm::ivec2 ppos(pacman.grid_x, pacman.grid_y);
+        // Large mazes path through the hierarchy instead of a full BFS
+        // every time Pac-Man moves
+        if (!maze.getHierarchy()) maze.updateDistanceField(ppos.x, ppos.y);
+
+        // One danger field per Pac-Man move, shared by every frightened ghost
+        bool frightened = false;
+        for (const Ghost& ghost : ghosts) frightened |= (ghost.mode == GhostMode::FRIGHTENED && !ghost.isEaten);
+        if (frightened) influence.update(maze, ppos, pacman.current_dir);
+
+        for (auto& ghost : ghosts) {
+            ghost.updateAI(maze, ppos, rng.next(), &influence);
+            ghost.update(dt);
+        }
+        resolveCollisions();
+    }
+    else if (pacman.isDead && !gameOver) {
+        deathTimer -= dt;
+        if (deathTimer <= 0.0f) {
+            if (pacman.lives <= 0) {
+                gameOver = true;
+                if (logging) std::cout << "\n=== GAME OVER === Score: " << pacman.score << std::endl;
+                events.push_back({SimEventType::GAME_OVER, pacman.score});
+            } else {
+                respawnAll();
+                if (logging) std::cout << "Lives: " << pacman.lives << std::endl;
+            }
+        }
+    }
+}
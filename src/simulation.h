@@ -0,0 +1,136 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "collisiongrid.h"
+#include "maze.h"
+#include "pacman.h"
+#include "ghost.h"
+#include "influencemap.h"
+#include "simstate.h"
+#include "pathtable.h"
+#include "simrandom.h"
+
+/**
+ * Things the simulation reports to the presentation side
+ * (audio, UI, console).
+ */
+enum class SimEventType {
+    SCORE_CHANGED,
+    PACMAN_DIED,
+    GAME_OVER,
+    LEVEL_CLEARED
+};
+
+struct SimEvent {
+    SimEventType type;
+    int score;
+};
+
+/**
+ * Simulation holds the complete game state (maze, Pac-Man, ghosts) and
+ * advances it one tick at a time. It has no GL, window or audio
+ * dependencies; presentation reacts to the events it emits.
+ */
+class Simulation {
+public:
+    Simulation();
+
+    // Load the level and place all entities. With precompute_paths, ghost
+    // pathing uses all-pairs tables cached beside the level file.
+    bool init(const std::string& level_path, bool precompute_paths = true);
+
+    // As above for a layout built in memory (e.g. by MazeGenerator). Its
+    // path table is used if it has one.
+    bool init(const Maze& layout, bool precompute_paths = true);
+
+    // Take a level already loaded from level_path, path table and all
+    // (LevelManager); nothing is read or built here
+    bool init(Maze&& level, const std::string& level_path);
+
+    // Put the level's pellets back and reset score, lives and entities.
+    // Only tiles eaten since the level started are rewritten.
+    void newGame();
+
+    // Advance the game by dt seconds with the given player input
+    void step(float dt, Direction input);
+
+    // Seed for the game's random choices; applied by the next newGame()
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const { return seed; }
+
+    // Ticks stepped since init() or the last newGame()
+    uint64_t getTick() const { return tick; }
+
+    // Empty for layouts passed to init() directly
+    const std::string& getLevelPath() const { return levelPath; }
+
+    // Console output for score, deaths and game over (on by default)
+    void setLogging(bool enabled);
+
+    // Hash of the full game state, for detecting replay desyncs
+    uint64_t checksum() const;
+
+    // Snapshot / roll back the game. The pellet board is shared with the
+    // previous snapshot until a pellet is eaten, and restoring only touches
+    // the maze tiles that differ. Events are not part of the state.
+    void saveState(SimState& state) const;
+    void loadState(const SimState& state);
+
+    static constexpr float DEATH_DELAY = 1.5f;
+    static constexpr int FIRST_GHOST_BONUS = 200;
+
+    Maze maze;
+    PacMan pacman;
+    std::vector<Ghost> ghosts;
+    bool gameOver;
+    bool levelCleared;
+
+    // Incremented whenever pellet state changes
+    unsigned int pelletVersion;
+
+    // Events emitted since the caller last cleared this list
+    std::vector<SimEvent> events;
+
+    // Danger/home fields frightened ghosts flee by; current while any
+    // ghost is frightened
+    const InfluenceMap& getInfluence() const { return influence; }
+
+private:
+    std::string levelPath;
+    std::shared_ptr<const PelletBoard> startBoard;  // pellets as the level starts
+    bool logging;
+    float deathTimer;
+    int ghostEatBonus;
+    int lastScore;
+    uint64_t seed;
+    SimRandom rng;
+    uint64_t tick;
+
+    // Pellet board matching the maze while boardVersion == pelletVersion
+    mutable std::shared_ptr<const PelletBoard> pelletBoard;
+    mutable unsigned int boardVersion;
+
+    InfluenceMap influence;
+
+    // Ghosts bucketed by tile for collision tests
+    CollisionGrid collisionGrid;
+    std::vector<int32_t> collisionHits;
+
+    void respawnAll();
+
+    // Influence map for the loaded layout, homed on the ghost spawns
+    void buildInfluence();
+
+    // Place everything at the start of the loaded layout
+    void startLevel();
+
+    // Pac-Man against every ghost on his tile, or swapping tiles with him
+    // this tick, in ghost order
+    void resolveCollisions();
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,45 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Bounded lock-free single-producer/single-consumer ring buffer.
+ * One thread may push, one (other) thread may pop. Capacity must be
+ * a power of two; one slot is kept free to tell full from empty.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side. Returns false if the queue is full.
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) & (Capacity - 1);
+        if (next == head.load(std::memory_order_acquire)) return false;
+        items[t] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = items[h];
+        head.store((h + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> items;
+    alignas(64) std::atomic<size_t> head;   // Consumer index
+    alignas(64) std::atomic<size_t> tail;   // Producer index
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,94 @@
+#include "threadpool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threads)
+    : stopping(false)
+    , job(nullptr)
+    , jobGrain(1)
+    , jobGeneration(0)
+    , busyWorkers(0)
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    slices = std::make_unique<Slice[]>(threads);
+    for (unsigned int i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    parallelFor(count, grain, [&fn](size_t begin, size_t end, unsigned int) { fn(begin, end); });
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t, unsigned int)>& fn) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    // Not worth waking anyone for a single chunk
+    if (workers.empty() || count <= grain) {
+        fn(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        unsigned int participants = getThreadCount();
+        for (unsigned int i = 0; i < participants; i++) {
+            slices[i].next = count * i / participants;
+            slices[i].end = count * (i + 1) / participants;
+        }
+        job = &fn;
+        jobGrain = grain;
+        busyWorkers = static_cast<unsigned int>(workers.size());
+        jobGeneration++;
+    }
+    wake.notify_all();
+
+    runChunks(0);
+
+    // fn must outlive every worker's use of it
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busyWorkers == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::runChunks(unsigned int index) {
+    unsigned int participants = getThreadCount();
+
+    // Own slice first, then steal from the others in turn
+    for (unsigned int offset = 0; offset < participants; offset++) {
+        Slice& slice = slices[(index + offset) % participants];
+        for (;;) {
+            size_t begin = slice.next.fetch_add(jobGrain);
+            if (begin >= slice.end) break;
+            (*job)(begin, std::min(begin + jobGrain, slice.end), index);
+        }
+    }
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        runChunks(index);
+
+        if (busyWorkers.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads for data-parallel loops. parallelFor gives
+ * each participant (the workers and the calling thread) a contiguous
+ * slice of [0, count), which it works through in chunks; once its own
+ * slice is done it steals chunks from the others' slices, so uneven work
+ * still finishes together.
+ */
+class ThreadPool {
+public:
+    // 0 threads = one per hardware thread (the caller counts as one)
+    explicit ThreadPool(unsigned int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Run fn(begin, end) over [0, count) in chunks of at most grain items
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    // As above; fn also gets the index (< getThreadCount()) of the thread
+    // running the chunk, for per-worker scratch and output buffers
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t, unsigned int)>& fn);
+
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+private:
+    // One participant's share of the current job
+    struct alignas(64) Slice {
+        std::atomic<size_t> next{0};
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Slice[]> slices;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping;
+
+    // Current job (guarded by mutex except for the atomics)
+    const std::function<void(size_t, size_t, unsigned int)>* job;
+    size_t jobGrain;
+    uint64_t jobGeneration;
+    std::atomic<unsigned int> busyWorkers;
+
+    void workerLoop(unsigned int index);
+    void runChunks(unsigned int index);
+};
+
+#endif // THREADPOOL_H
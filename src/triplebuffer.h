@@ -0,0 +1,50 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free triple buffer for handing the latest value from one producer
+ * thread to one consumer thread. The producer fills the back slot and
+ * publishes it; the consumer always reads the newest published slot.
+ * Neither side ever waits, and a published slot is never written again
+ * until the consumer has moved off it.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    // Producer: slot to fill for the next publish
+    T& getBack() { return slots[back]; }
+
+    // Producer: make the back slot the newest value
+    void publish() {
+        uint8_t prev = middle.exchange(static_cast<uint8_t>(back | DIRTY_BIT), std::memory_order_acq_rel);
+        back = prev & INDEX_MASK;
+    }
+
+    // Consumer: switch to the newest published slot if there is one.
+    // Returns true if the front slot changed.
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & DIRTY_BIT) == 0) return false;
+        uint8_t prev = middle.exchange(front, std::memory_order_acq_rel);
+        front = prev & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer: current slot (stable until the next update())
+    const T& getFront() const { return slots[front]; }
+
+private:
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    T slots[3];
+    std::atomic<uint8_t> middle;    // Shared slot index plus dirty flag
+    uint8_t back;                   // Owned by producer
+    uint8_t front;                  // Owned by consumer
+};
+
+#endif // TRIPLEBUFFER_H
@@ -90,9 +90,9 @@ void UIManager::createButtons() {
                 glm::vec3(200, 50, 10),
                 glm::vec3(0.2f, 0.6f, 0.2f),
                 glm::vec3(0.3f, 0.8f, 0.3f),
-                "PLAY AGAIN",
+                "NEXT LEVEL",
                 false,
-                [this]() { if (onRestartGame) onRestartGame(); }
+                [this]() { if (onNextLevel) onNextLevel(); else if (onRestartGame) onRestartGame(); }
             });
             buttons.push_back({
                 glm::vec3(centerX, centerY + 100, 0),
@@ -171,7 +171,6 @@ void UIManager::renderPanel(Shader& shader, const glm::vec3& pos, const glm::vec
     shader.setMat4("projection", ortho);
     shader.setMat4("view", view);
     shader.setVec3("colorTint", color);
-    shader.setBool("useTexture", false);
     
     // Create a flat quad at position with size
     float left = pos.x - size.x / 2.0f;
@@ -51,6 +51,7 @@ public:
     std::function<void()> onStartGame;
     std::function<void()> onResumeGame;
     std::function<void()> onRestartGame;
+    std::function<void()> onNextLevel;
     std::function<void()> onQuitGame;
     
 private: